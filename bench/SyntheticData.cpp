@@ -0,0 +1,156 @@
+#include "SyntheticData.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <thread>
+
+namespace imagined {
+
+namespace {
+
+const std::array<const char*, 16> kFirstNames = {
+    "Ada", "Ben", "Chloe", "Diego", "Elena", "Farid", "Grace", "Hiro",
+    "Ines", "Jonas", "Kemi", "Luca", "Maya", "Noah", "Olga", "Priya"};
+const std::array<const char*, 16> kLastNames = {
+    "Alvarez", "Brown", "Chen", "Dubois", "Eriksen", "Fischer", "Garcia", "Haddad",
+    "Ivanova", "Jensen", "Kim", "Lopez", "Moreau", "Nakamura", "Okafor", "Patel"};
+const std::array<const char*, 12> kTimezones = {
+    "UTC-8", "UTC-7", "UTC-6", "UTC-5", "UTC-3", "UTC", "UTC+1", "UTC+2",
+    "UTC+3", "UTC+5:30", "UTC+8", "UTC+9"};
+const std::array<const char*, 8> kLanguages = {
+    "English", "Spanish", "French", "German", "Portuguese", "Japanese", "Hindi", "Mandarin"};
+const std::array<const char*, 5> kResourceTypes = {
+    "workstation", "render-node", "studio", "camera", "license"};
+const std::array<double, kExperienceLevelCount> kMedianRate = {35.0, 55.0, 85.0, 120.0};
+
+} // namespace
+
+SyntheticDataGenerator::SyntheticDataGenerator(std::uint64_t seed)
+    : engine_(seed),
+      now_(std::chrono::system_clock::now()),
+      // Indexed by SkillType
+      skillWeights_({6, 14, 18, 9, 12, 8, 6, 7, 10, 4}),
+      levelWeights_({35, 35, 20, 10}),
+      // Indexed by ProjectStatus
+      statusWeights_({20, 45, 10, 20, 5}),
+      resourceTypeWeights_({50, 20, 10, 10, 10}),
+      rateNoise_(0.0, 0.3),
+      budgetNoise_(0.0, 0.8) {}
+
+std::size_t SyntheticDataGenerator::zipf(std::size_t range) {
+    // Inverse-CDF approximation of a Zipf(1) draw over [0, range)
+    double u = std::uniform_real_distribution<double>(0.0, 1.0)(engine_);
+    auto rank = static_cast<std::size_t>(std::pow(static_cast<double>(range) + 1.0, u)) - 1;
+    return std::min(rank, range - 1);
+}
+
+SkillSet SyntheticDataGenerator::skills() {
+    SkillSet result;
+    std::size_t count = 1 + engine_() % 4;
+    while (result.size() < count) {
+        result.insert(static_cast<SkillType>(skillWeights_(engine_)));
+    }
+    return result;
+}
+
+Project SyntheticDataGenerator::project(std::size_t index) {
+    Project project;
+    project.name = "Project " + std::to_string(index);
+    project.clientId = "client-" + std::to_string(zipf(std::max<std::size_t>(1, index / 20 + 50)));
+    project.type = static_cast<ProjectType>(engine_() % kProjectTypeCount);
+    project.status = static_cast<ProjectStatus>(statusWeights_(engine_));
+    project.deadline = now_ + std::chrono::hours(24 * (static_cast<int>(engine_() % 211) - 30));
+    project.budget = std::round(25000.0 * std::exp(budgetNoise_(engine_)));
+    project.projectManager = std::string(kFirstNames[engine_() % kFirstNames.size()]) + " " +
+                             kLastNames[engine_() % kLastNames.size()];
+    project.description = "Synthetic project " + std::to_string(index);
+    return project;
+}
+
+Talent SyntheticDataGenerator::talent(std::size_t index) {
+    Talent talent;
+    const char* first = kFirstNames[engine_() % kFirstNames.size()];
+    const char* last = kLastNames[engine_() % kLastNames.size()];
+    talent.name = std::string(first) + " " + last;
+    talent.email = std::string(first) + "." + last + "." + std::to_string(index) + "@example.com";
+    std::transform(talent.email.begin(), talent.email.end(), talent.email.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    talent.skills = skills();
+    int level = levelWeights_(engine_);
+    talent.experienceLevel = static_cast<ExperienceLevel>(level);
+    talent.hourlyRate = std::round(kMedianRate[level] * std::exp(rateNoise_(engine_)));
+    talent.isAvailable = engine_() % 10 < 7;
+    talent.timezone = kTimezones[engine_() % kTimezones.size()];
+    talent.preferredLanguage = kLanguages[zipf(kLanguages.size())];
+    return talent;
+}
+
+Resource SyntheticDataGenerator::resource(std::size_t index) {
+    Resource resource;
+    resource.type = kResourceTypes[resourceTypeWeights_(engine_)];
+    resource.name = resource.type.str() + " " + std::to_string(index);
+    resource.isAvailable = engine_() % 10 < 9;
+    resource.lastUsed = now_ - std::chrono::hours(engine_() % (24 * 30));
+    return resource;
+}
+
+AllocationRequest SyntheticDataGenerator::allocationRequest(const std::string& projectId) {
+    AllocationRequest request;
+    request.projectId = projectId;
+    std::size_t skillCount = 1 + engine_() % 2;
+    SkillSet required;
+    while (required.size() < skillCount) {
+        required.insert(static_cast<SkillType>(skillWeights_(engine_)));
+    }
+    for (SkillType skill : required) {
+        request.requiredSkills.push_back(std::to_string(static_cast<int>(skill)));
+    }
+    request.requiredTeamSize = 1 + static_cast<int>(engine_() % 3);
+    request.startDate = now_ + std::chrono::hours(24 * (engine_() % 90));
+    request.endDate = request.startDate + std::chrono::hours(24 * (1 + engine_() % 14));
+    request.budget = 0.0;
+    return request;
+}
+
+SyntheticDataset populateSyntheticData(ProjectManager& projectManager, TalentManager& talentManager,
+                                       ResourceAllocator& resourceAllocator,
+                                       const SyntheticDataOptions& options) {
+    SyntheticDataset dataset;
+    dataset.projectIds.resize(options.projects);
+    dataset.talentIds.resize(options.talents);
+    dataset.resourceIds.resize(options.resources);
+
+    // Each thread fills a contiguous slice of every table with its own
+    // generator, so the output depends only on the seed and thread count
+    std::size_t threads = std::max<std::size_t>(1, options.threads);
+    auto fill = [&](std::size_t part) {
+        SyntheticDataGenerator generator(options.seed + part);
+        auto slice = [&](std::size_t total, auto&& create) {
+            for (std::size_t i = total * part / threads; i < total * (part + 1) / threads; ++i) {
+                create(i);
+            }
+        };
+        slice(options.projects, [&](std::size_t i) {
+            dataset.projectIds[i] = projectManager.createProject(generator.project(i));
+        });
+        slice(options.talents, [&](std::size_t i) {
+            dataset.talentIds[i] = talentManager.addTalent(generator.talent(i));
+        });
+        slice(options.resources, [&](std::size_t i) {
+            dataset.resourceIds[i] = resourceAllocator.addResource(generator.resource(i));
+        });
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t part = 1; part < threads; ++part) {
+        workers.emplace_back(fill, part);
+    }
+    fill(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return dataset;
+}
+
+} // namespace imagined
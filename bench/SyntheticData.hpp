@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "core/ProjectManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "core/TalentManager.hpp"
+
+namespace imagined {
+
+struct SyntheticDataOptions {
+    std::size_t projects = 10000;
+    std::size_t talents = 10000;
+    std::size_t resources = 10000;
+    std::uint64_t seed = 42;
+    std::size_t threads = 1;  // Populate in parallel; the managers must be sharded to benefit
+};
+
+// Deterministic generator of studio-shaped records. Distributions follow a
+// mid-size agency rather than uniform noise:
+// - skills: 1-4 per talent, popularity skewed toward web/app/brand work
+// - experience: 35% junior, 35% mid, 20% senior, 10% lead
+// - hourly rate: log-normal around a per-level median (35/55/85/120)
+// - clients: Zipf-like, a few clients own many projects
+// - project status: mostly in progress, deadlines from -30 to +180 days
+// The same seed and index sequence always produce the same records.
+class SyntheticDataGenerator {
+public:
+    explicit SyntheticDataGenerator(std::uint64_t seed);
+
+    Project project(std::size_t index);
+    Talent talent(std::size_t index);
+    Resource resource(std::size_t index);
+    SkillSet skills();
+    // A request of 1-2 skills and a 1-3 person team over a window in the
+    // next 90 days
+    AllocationRequest allocationRequest(const std::string& projectId);
+
+    std::mt19937_64& engine() { return engine_; }
+
+private:
+    std::mt19937_64 engine_;
+    std::chrono::system_clock::time_point now_;
+    std::discrete_distribution<int> skillWeights_;
+    std::discrete_distribution<int> levelWeights_;
+    std::discrete_distribution<int> statusWeights_;
+    std::discrete_distribution<int> resourceTypeWeights_;
+    std::normal_distribution<double> rateNoise_;
+    std::normal_distribution<double> budgetNoise_;
+
+    std::size_t zipf(std::size_t range);
+};
+
+// IDs of the generated records, in generation order
+struct SyntheticDataset {
+    std::vector<std::string> projectIds;
+    std::vector<std::string> talentIds;
+    std::vector<std::string> resourceIds;
+};
+
+SyntheticDataset populateSyntheticData(ProjectManager& projectManager, TalentManager& talentManager,
+                                       ResourceAllocator& resourceAllocator,
+                                       const SyntheticDataOptions& options);
+
+} // namespace imagined
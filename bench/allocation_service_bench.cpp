@@ -0,0 +1,186 @@
+// Open-loop latency benchmark for AllocationService.
+//
+// For every worker count and arrival rate, a single client thread submits
+// allocation requests at exponentially distributed intervals for --seconds,
+// without waiting for earlier ones to finish. Latency is measured from each
+// request's scheduled arrival to its completion callback, so time a request
+// spends waiting for queue room under BLOCK backpressure, or a client that
+// fell behind its schedule, is counted rather than hidden. Requests draw
+// their project from the first --projects projects; fewer projects mean more
+// requests coalescing per project.
+//
+// All runs share one fixture, so later runs see the bookings of earlier ones.
+//
+// Output is CSV: workers, offered rate, submitted, completed, refused,
+// p50/p99/max latency in microseconds and completed requests per second.
+//
+// Usage: imagined_studio_service_bench [--entities N] [--seconds S]
+//                                      [--rates R,R,...] [--workers W,W,...]
+//                                      [--capacity C] [--projects P]
+//                                      [--backpressure block|reject]
+//                                      [--shards K] [--seed S]
+
+#include "services/AllocationService.hpp"
+#include "SyntheticData.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace imagined;
+
+namespace {
+
+struct Options {
+    std::size_t entities = 10000;
+    double seconds = 2.0;
+    std::vector<std::size_t> rates = {100, 200, 400};
+    std::vector<std::size_t> workers = {1, 2, 4};
+    std::size_t capacity = 1024;
+    std::size_t projects = 256;
+    bool reject = false;
+    std::size_t shards = 16;
+    std::uint64_t seed = 42;
+};
+
+std::vector<std::size_t> parseList(const char* text) {
+    std::vector<std::size_t> values;
+    while (*text != '\0') {
+        char* end;
+        std::size_t value = std::strtoull(text, &end, 10);
+        if (end == text) {
+            break;
+        }
+        values.push_back(value);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--entities") == 0) {
+            options.entities = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seconds") == 0) {
+            options.seconds = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--rates") == 0) {
+            options.rates = parseList(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--workers") == 0) {
+            options.workers = parseList(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--capacity") == 0) {
+            options.capacity = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--projects") == 0) {
+            options.projects = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--backpressure") == 0) {
+            options.reject = std::strcmp(argv[i + 1], "reject") == 0;
+        } else if (std::strcmp(argv[i], "--shards") == 0) {
+            options.shards = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+    }
+    return options;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void runLoad(ResourceAllocator& resources, SyntheticDataGenerator& generator,
+             const std::vector<std::string>& projectIds, const Options& options,
+             std::size_t workers, std::size_t rate) {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937_64& rng = generator.engine();
+    std::exponential_distribution<double> gap(static_cast<double>(rate));
+
+    // Schedule and requests are prepared up front to keep the client on time
+    std::vector<Clock::duration> arrivals;
+    std::vector<AllocationRequest> requests;
+    double at = gap(rng);
+    while (at < options.seconds) {
+        arrivals.push_back(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(at)));
+        requests.push_back(generator.allocationRequest(projectIds[rng() % projectIds.size()]));
+        at += gap(rng);
+    }
+    std::vector<double> latencies(arrivals.size(), -1.0);
+
+    AllocationService::Options serviceOptions;
+    serviceOptions.workers = workers;
+    serviceOptions.queueCapacity = options.capacity;
+    serviceOptions.backpressure = options.reject ? AllocationService::Backpressure::REJECT
+                                                 : AllocationService::Backpressure::BLOCK;
+    std::size_t refused = 0;
+    Clock::time_point begin;
+    Clock::duration elapsed;
+    {
+        AllocationService service(resources, serviceOptions);
+        begin = Clock::now();
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            Clock::time_point scheduled = begin + arrivals[i];
+            std::this_thread::sleep_until(scheduled);
+            auto record = [&latencies, i, scheduled](AllocationResult) {
+                latencies[i] = std::chrono::duration<double, std::micro>(Clock::now() - scheduled).count();
+            };
+            bool accepted = service.submitAllocation(std::move(requests[i]), record);
+            if (!accepted) {
+                ++refused;
+            }
+        }
+        service.shutdown();
+        elapsed = Clock::now() - begin;
+    }
+
+    std::vector<double> completed;
+    completed.reserve(latencies.size());
+    for (double latency : latencies) {
+        if (latency >= 0.0) {
+            completed.push_back(latency);
+        }
+    }
+    std::sort(completed.begin(), completed.end());
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::cout << workers << "," << rate << "," << requests.size() << "," << completed.size() << ","
+              << refused << "," << percentile(completed, 0.50) << "," << percentile(completed, 0.99) << ","
+              << (completed.empty() ? 0.0 : completed.back()) << ","
+              << static_cast<double>(completed.size()) / seconds << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    ProjectManager projects(options.shards);
+    TalentManager talents(options.shards);
+    ResourceAllocator resources(projects, talents, options.shards);
+    SyntheticDataOptions dataOptions;
+    dataOptions.projects = options.entities;
+    dataOptions.talents = options.entities;
+    dataOptions.resources = options.entities;
+    dataOptions.seed = options.seed;
+    SyntheticDataset data = populateSyntheticData(projects, talents, resources, dataOptions);
+    data.projectIds.resize(std::min(data.projectIds.size(), options.projects));
+    if (data.projectIds.empty()) {
+        return 0;
+    }
+    SyntheticDataGenerator generator(options.seed ^ 0x9e3779b97f4a7c15ull);
+
+    std::cout << "workers,rate,submitted,completed,refused,p50_us,p99_us,max_us,completed_per_sec" << std::endl;
+    for (std::size_t workers : options.workers) {
+        for (std::size_t rate : options.rates) {
+            runLoad(resources, generator, data.projectIds, options, std::max<std::size_t>(1, workers),
+                    std::max<std::size_t>(1, rate));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Multithreaded throughput benchmark for the sharded managers.
+//
+// Runs a mixed read/write workload against ProjectManager, TalentManager and
+// ResourceAllocator at 1, 2, 4, ... threads, once with a single shard (every
+// call serialized on one lock, like a global mutex) and once with the
+// requested shard count, and prints the scaling curve as CSV.
+//
+// Usage: imagined_studio_concurrency_bench [--entities N] [--seconds S]
+//                                          [--max-threads T] [--shards K]
+//                                          [--write-percent P]
+
+#include "core/ProjectManager.hpp"
+#include "core/TalentManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "SyntheticData.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace imagined;
+
+namespace {
+
+struct Options {
+    std::size_t entities = 100000;
+    double seconds = 1.0;
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t shards = 64;
+    unsigned writePercent = 20;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--entities") == 0) {
+            options.entities = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seconds") == 0) {
+            options.seconds = std::strtod(argv[i + 1], nullptr);
+        } else if (std::strcmp(argv[i], "--max-threads") == 0) {
+            options.maxThreads = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--shards") == 0) {
+            options.shards = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--write-percent") == 0) {
+            options.writePercent = static_cast<unsigned>(std::strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+    return options;
+}
+
+struct Fixture {
+    ProjectManager projects;
+    TalentManager talents;
+    ResourceAllocator resources;
+    std::vector<std::string> projectIds;
+    std::vector<std::string> talentIds;
+    std::vector<std::string> resourceIds;
+
+    Fixture(std::size_t shards, std::size_t entities)
+        : projects(shards), talents(shards), resources(projects, talents, shards) {
+        SyntheticDataOptions dataOptions;
+        dataOptions.projects = entities;
+        dataOptions.talents = entities;
+        dataOptions.resources = entities;
+        SyntheticDataset data = populateSyntheticData(projects, talents, resources, dataOptions);
+        projectIds = std::move(data.projectIds);
+        talentIds = std::move(data.talentIds);
+        resourceIds = std::move(data.resourceIds);
+    }
+};
+
+double runWorkload(Fixture& fixture, std::size_t threads, const Options& options) {
+    std::atomic<bool> start{false};
+    std::atomic<bool> stop{false};
+    std::vector<std::uint64_t> counts(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937_64 gen(t + 1);
+            std::uint64_t ops = 0;
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::size_t i = gen() % fixture.projectIds.size();
+                bool write = gen() % 100 < options.writePercent;
+                switch (gen() % 3) {
+                case 0:
+                    if (write) {
+                        fixture.projects.updateProjectStatus(fixture.projectIds[i],
+                            static_cast<ProjectStatus>(gen() % 3));
+                    } else {
+                        fixture.projects.withProject(fixture.projectIds[i], [](const Project&) {});
+                    }
+                    break;
+                case 1:
+                    if (write) {
+                        fixture.talents.updateAvailability(fixture.talentIds[i], gen() % 2 == 0);
+                    } else {
+                        fixture.talents.withTalent(fixture.talentIds[i], [](const Talent&) {});
+                    }
+                    break;
+                default:
+                    if (write) {
+                        fixture.resources.updateResourceAvailability(fixture.resourceIds[i], true);
+                    } else {
+                        fixture.resources.withResource(fixture.resourceIds[i], [](const Resource&) {});
+                    }
+                    break;
+                }
+                ++ops;
+            }
+            counts[t] = ops;
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop.store(true);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::uint64_t total = 0;
+    for (std::uint64_t count : counts) {
+        total += count;
+    }
+    return static_cast<double>(total) / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    std::cout << "shards,threads,ops_per_sec,speedup" << std::endl;
+    for (std::size_t shards : {std::size_t(1), options.shards}) {
+        Fixture fixture(shards, options.entities);
+        double baseline = 0.0;
+        for (std::size_t threads = 1; threads <= options.maxThreads; threads *= 2) {
+            double throughput = runWorkload(fixture, threads, options);
+            if (threads == 1) {
+                baseline = throughput;
+            }
+            std::cout << shards << "," << threads << "," << static_cast<std::uint64_t>(throughput)
+                      << "," << throughput / baseline << std::endl;
+        }
+    }
+    return 0;
+}
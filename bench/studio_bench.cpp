@@ -0,0 +1,473 @@
+// Latency benchmarks for the public manager operations on synthetic data.
+//
+// For every scale the managers are filled with that many projects, talents
+// and resources from SyntheticDataGenerator, then each operation is timed
+// call by call. Point operations run --iterations times; scans and other
+// operations whose cost grows with the data, allocation included, run
+// proportionally fewer times. Benchmarks run in a fixed order on one fixture
+// per scale, so mutating operations see the state left by earlier ones.
+//
+// Output is one row per benchmark and scale, as CSV (default) or JSON lines:
+// benchmark, scale, iterations, mean/p50/p99/max nanoseconds, ops/sec, heap
+// allocations per operation and the resident set size after the benchmark.
+// Allocations are counted on the benchmarking thread, so they include the
+// input generated inside the timed loop; for populate they are the
+// allocations made inside the manager calls on all loader threads.
+//
+// --memory picks the memory resource the managers allocate from: the global
+// heap (default), a synchronized pool, or a monotonic arena (serialized by a
+// mutex, since the loader threads share it).
+//
+// --feed attaches a ChangeFeed of that capacity to the managers, so the
+// mutating operations include publishing their change events, and adds a
+// feed.poll benchmark reading them back in batches of 256.
+//
+// Usage: imagined_studio_bench [--scales N,N,...] [--iterations I]
+//                              [--shards K] [--threads T] [--seed S]
+//                              [--filter SUBSTRING] [--format csv|json]
+//                              [--memory default|pool|monotonic]
+//                              [--feed CAPACITY]
+
+#include "core/ChangeFeed.hpp"
+#include "core/Metrics.hpp"
+#include "core/ProjectManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "core/TalentColumns.hpp"
+#include "core/TalentManager.hpp"
+#include "SyntheticData.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace imagined;
+
+namespace {
+
+struct Options {
+    std::vector<std::size_t> scales = {1000, 10000, 100000};
+    std::size_t iterations = 10000;
+    std::size_t shards = 16;
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = 42;
+    std::string filter;
+    bool json = false;
+    std::string memory = "default";
+    std::size_t feedCapacity = 0;
+};
+
+std::vector<std::size_t> parseList(const char* text) {
+    std::vector<std::size_t> values;
+    while (*text != '\0') {
+        char* end;
+        std::size_t value = std::strtoull(text, &end, 10);
+        if (end == text) {
+            break;
+        }
+        values.push_back(value);
+        text = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--scales") == 0) {
+            options.scales = parseList(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--iterations") == 0) {
+            options.iterations = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--shards") == 0) {
+            options.shards = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--threads") == 0) {
+            options.threads = std::max<std::size_t>(1, std::strtoull(argv[i + 1], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--seed") == 0) {
+            options.seed = std::strtoull(argv[i + 1], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--filter") == 0) {
+            options.filter = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--format") == 0) {
+            options.json = std::strcmp(argv[i + 1], "json") == 0;
+        } else if (std::strcmp(argv[i], "--memory") == 0) {
+            options.memory = argv[i + 1];
+        } else if (std::strcmp(argv[i], "--feed") == 0) {
+            options.feedCapacity = std::strtoull(argv[i + 1], nullptr, 10);
+        }
+    }
+    return options;
+}
+
+// Serializes a resource that is not thread-safe, such as an arena shared by
+// the loader threads and the shards
+class LockedResource : public std::pmr::memory_resource {
+public:
+    explicit LockedResource(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+
+private:
+    std::mutex mutex_;
+    std::pmr::memory_resource* upstream_;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return upstream_->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        upstream_->deallocate(memory, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// Resident set size in KiB, 0 where /proc is unavailable
+std::size_t residentKilobytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t totalPages = 0;
+    std::size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+    return residentPages * 4;
+}
+
+class BenchRunner {
+public:
+    BenchRunner(const Options& options, std::size_t scale)
+        : options_(options),
+          scale_(scale),
+          // Scans touch the whole data set; keep their total work near
+          // `iterations` point calls at the 1000-record scale
+          scanIterations_(std::clamp<std::size_t>(options.iterations * 1000 / std::max<std::size_t>(scale, 1) / 100,
+                                                  3, options.iterations)) {}
+
+    std::size_t pointIterations() const { return options_.iterations; }
+    std::size_t scanIterations() const { return scanIterations_; }
+
+    // Times `op(i)` for i in [0, iterations) and prints one row
+    template <typename Op>
+    void run(const std::string& name, std::size_t iterations, Op&& op) {
+        if (iterations == 0 || (!options_.filter.empty() && name.find(options_.filter) == std::string::npos)) {
+            return;
+        }
+        samples_.resize(iterations);
+        std::uint64_t allocationsBefore = Metrics::heapAllocations();
+        for (std::size_t i = 0; i < iterations; ++i) {
+            auto begin = std::chrono::steady_clock::now();
+            op(i);
+            samples_[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        }
+        // The sample vector is sized before counting starts, so it adds nothing
+        report(name, samples_, Metrics::heapAllocations() - allocationsBefore);
+    }
+
+    // Reports an operation timed as a whole, e.g. a bulk load
+    void record(const std::string& name, std::size_t operations, std::chrono::nanoseconds total,
+                std::uint64_t heapAllocations) {
+        if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+            return;
+        }
+        samples_.assign(std::max<std::size_t>(operations, 1),
+                        static_cast<double>(total.count()) / std::max<std::size_t>(operations, 1));
+        report(name, samples_, heapAllocations);
+    }
+
+    static void printHeader(const Options& options) {
+        if (!options.json) {
+            std::cout << "benchmark,scale,iterations,mean_ns,p50_ns,p99_ns,max_ns,ops_per_sec,allocs_per_op,rss_kb" << std::endl;
+        }
+    }
+
+private:
+    const Options& options_;
+    std::size_t scale_;
+    std::size_t scanIterations_;
+    std::vector<double> samples_;
+
+    void report(const std::string& name, std::vector<double>& samples, std::uint64_t heapAllocations) {
+        double total = 0.0;
+        for (double sample : samples) {
+            total += sample;
+        }
+        double mean = total / static_cast<double>(samples.size());
+        auto percentile = [&](double fraction) {
+            auto rank = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1));
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            return samples[rank];
+        };
+        double p50 = percentile(0.50);
+        double p99 = percentile(0.99);
+        double max = *std::max_element(samples.begin(), samples.end());
+        double opsPerSecond = mean > 0.0 ? 1e9 / mean : 0.0;
+        double allocationsPerOp = static_cast<double>(heapAllocations) / static_cast<double>(samples.size());
+        std::size_t rss = residentKilobytes();
+
+        if (options_.json) {
+            std::cout << "{\"benchmark\":\"" << name << "\",\"scale\":" << scale_
+                      << ",\"iterations\":" << samples.size() << ",\"mean_ns\":" << mean
+                      << ",\"p50_ns\":" << p50 << ",\"p99_ns\":" << p99 << ",\"max_ns\":" << max
+                      << ",\"ops_per_sec\":" << opsPerSecond << ",\"allocs_per_op\":" << allocationsPerOp
+                      << ",\"rss_kb\":" << rss << "}" << std::endl;
+        } else {
+            std::cout << name << "," << scale_ << "," << samples.size() << "," << mean << "," << p50
+                      << "," << p99 << "," << max << "," << opsPerSecond << "," << allocationsPerOp << ","
+                      << rss << std::endl;
+        }
+    }
+};
+
+// Heap allocations made inside the manager calls of a bulk load, summed over
+// all threads through the metrics of the insert operations
+std::uint64_t insertAllocations(const MetricsSnapshot& snapshot) {
+    std::uint64_t total = 0;
+    for (OperationId operation : {OperationId::CREATE_PROJECT, OperationId::ADD_TALENT, OperationId::ADD_RESOURCE}) {
+        if (const OperationStats* stats = snapshot.find(operation)) {
+            total += stats->heapAllocations;
+        }
+    }
+    return total;
+}
+
+void runScale(const Options& options, std::size_t scale) {
+    // Declared before the managers, which release into it on destruction
+    std::unique_ptr<std::pmr::memory_resource> arena;
+    std::unique_ptr<std::pmr::memory_resource> shared;
+    if (options.memory == "pool") {
+        shared = std::make_unique<std::pmr::synchronized_pool_resource>();
+    } else if (options.memory == "monotonic") {
+        arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+        shared = std::make_unique<LockedResource>(arena.get());
+    }
+    std::pmr::memory_resource* resource = shared ? shared.get() : std::pmr::get_default_resource();
+
+    ProjectManager projects(options.shards, resource);
+    TalentManager talents(options.shards, resource);
+    ResourceAllocator resources(projects, talents, options.shards, resource);
+    std::unique_ptr<ChangeFeed> feed;
+    if (options.feedCapacity > 0) {
+        feed = std::make_unique<ChangeFeed>(options.feedCapacity);
+        projects.attachChangeFeed(feed.get());
+        talents.attachChangeFeed(feed.get());
+        resources.attachChangeFeed(feed.get());
+    }
+    BenchRunner bench(options, scale);
+    const std::size_t points = bench.pointIterations();
+    const std::size_t scans = bench.scanIterations();
+
+    SyntheticDataOptions dataOptions;
+    dataOptions.projects = scale;
+    dataOptions.talents = scale;
+    dataOptions.resources = scale;
+    dataOptions.seed = options.seed;
+    dataOptions.threads = options.threads;
+    std::uint64_t allocationsBefore = insertAllocations(Metrics::snapshot());
+    Metrics::setEnabled(true);
+    auto loadBegin = std::chrono::steady_clock::now();
+    SyntheticDataset data = populateSyntheticData(projects, talents, resources, dataOptions);
+    auto loadTime = std::chrono::steady_clock::now() - loadBegin;
+    Metrics::setEnabled(false);
+    bench.record("populate", 3 * scale, loadTime, insertAllocations(Metrics::snapshot()) - allocationsBefore);
+    if (scale == 0) {
+        return;
+    }
+
+    SyntheticDataGenerator generator(options.seed ^ 0x9e3779b97f4a7c15ull);
+    std::mt19937_64& rng = generator.engine();
+    auto pick = [&](const std::vector<std::string>& ids) -> const std::string& { return ids[rng() % ids.size()]; };
+    auto now = std::chrono::system_clock::now();
+
+    // Projects
+    std::vector<std::string> created(points);
+    bench.run("project.create", points, [&](std::size_t i) {
+        created[i] = projects.createProject(generator.project(scale + i));
+    });
+    bench.run("project.get", points, [&](std::size_t) { projects.getProject(pick(data.projectIds)); });
+    bench.run("project.find", points, [&](std::size_t) { projects.findProject(pick(data.projectIds)); });
+    bench.run("project.with", points, [&](std::size_t) {
+        projects.withProject(pick(data.projectIds), [](const Project&) {});
+    });
+    bench.run("project.contains", points, [&](std::size_t) { projects.containsProject(pick(data.projectIds)); });
+    Project replacement = generator.project(0);
+    bench.run("project.update", points, [&](std::size_t) {
+        replacement.budget = static_cast<double>(rng() % 100000);
+        projects.updateProject(pick(created), replacement);
+    });
+    bench.run("project.updateStatus", points, [&](std::size_t) {
+        projects.updateProjectStatus(pick(created), static_cast<ProjectStatus>(rng() % 3));
+    });
+    std::vector<std::string> partners(points);
+    bench.run("project.assignTeamMember", points, [&](std::size_t i) {
+        partners[i] = pick(data.talentIds);
+        projects.assignTeamMember(created[i], partners[i]);
+    });
+    bench.run("project.removeTeamMember", points, [&](std::size_t i) {
+        projects.removeTeamMember(created[i], partners[i]);
+    });
+    bench.run("project.byStatus", scans, [&](std::size_t) { projects.getProjectsByStatus(ProjectStatus::IN_PROGRESS); });
+    bench.run("project.byClient", points, [&](std::size_t) {
+        projects.getProjectsByClient("client-" + std::to_string(rng() % 50));
+    });
+    bench.run("project.byType", scans, [&](std::size_t) {
+        projects.getProjectsByType(static_cast<ProjectType>(rng() % kProjectTypeCount));
+    });
+    bench.run("project.upcomingDeadlines", scans, [&](std::size_t) { projects.getUpcomingDeadlines(30); });
+    bench.run("project.upcomingDeadlinesPage", points, [&](std::size_t) {
+        projects.getUpcomingDeadlinesPage(30, 50);
+    });
+    bench.run("project.delete", points, [&](std::size_t i) { projects.deleteProject(created[i]); });
+
+    // Talents
+    bench.run("talent.add", points, [&](std::size_t i) { created[i] = talents.addTalent(generator.talent(scale + i)); });
+    bench.run("talent.get", points, [&](std::size_t) { talents.getTalent(pick(data.talentIds)); });
+    bench.run("talent.find", points, [&](std::size_t) { talents.findTalent(pick(data.talentIds)); });
+    bench.run("talent.with", points, [&](std::size_t) {
+        talents.withTalent(pick(data.talentIds), [](const Talent&) {});
+    });
+    bench.run("talent.contains", points, [&](std::size_t) { talents.containsTalent(pick(data.talentIds)); });
+    bench.run("talent.update", points, [&](std::size_t i) { talents.updateTalent(created[i], generator.talent(i)); });
+    bench.run("talent.updateAvailability", points, [&](std::size_t) {
+        talents.updateAvailability(pick(created), rng() % 2 == 0);
+    });
+    bench.run("talent.addSkill", points, [&](std::size_t i) {
+        talents.addSkill(created[i], static_cast<SkillType>(rng() % kSkillTypeCount));
+    });
+    bench.run("talent.removeSkill", points, [&](std::size_t i) {
+        talents.removeSkill(created[i], static_cast<SkillType>(rng() % kSkillTypeCount));
+    });
+    bench.run("talent.assignProject", points, [&](std::size_t i) {
+        partners[i] = pick(data.projectIds);
+        talents.assignProject(created[i], partners[i]);
+    });
+    bench.run("talent.projects", points, [&](std::size_t i) { talents.getTalentProjects(created[i]); });
+    bench.run("talent.removeProject", points, [&](std::size_t i) {
+        talents.removeProject(created[i], partners[i]);
+    });
+    bench.run("talent.bySkill", scans, [&](std::size_t) {
+        talents.getTalentsBySkill(static_cast<SkillType>(rng() % kSkillTypeCount));
+    });
+    bench.run("talent.availableWithSkills", scans, [&](std::size_t) {
+        talents.findAvailableTalentsWithSkills(generator.skills());
+    });
+    bench.run("talent.availableCandidates", points, [&](std::size_t) {
+        talents.findAvailableCandidates(generator.skills(), 10);
+    });
+    CandidateRanking ranking;
+    ranking.levelFactors = {1.0, 0.95, 0.90, 0.85};
+    ranking.loadFactor = 0.1;
+    bench.run("talent.rankedCandidates", points, [&](std::size_t) {
+        talents.findRankedCandidates(generator.skills(), 10, ranking);
+    });
+    bench.run("talent.available", scans, [&](std::size_t) { talents.getAvailableTalents(); });
+    bench.run("talent.search", scans, [&](std::size_t) { talents.searchTalents("chen"); });
+    bench.run("talent.searchLimit", points, [&](std::size_t) { talents.searchTalents("nakamura.1", 20); });
+    bench.run("talent.byLevel", scans, [&](std::size_t) {
+        talents.getTalentsByExperienceLevel(static_cast<ExperienceLevel>(rng() % kExperienceLevelCount));
+    });
+    bench.run("talent.byRateRange", scans, [&](std::size_t) { talents.getTalentsByHourlyRateRange(50.0, 60.0); });
+    TalentFilter filter;
+    filter.experienceLevel = ExperienceLevel::SENIOR;
+    filter.minRate = 70.0;
+    filter.maxRate = 90.0;
+    filter.availableOnly = true;
+    bench.run("talent.findTalents", points, [&](std::size_t) {
+        filter.requiredSkills = SkillSet{static_cast<SkillType>(rng() % kSkillTypeCount)};
+        talents.findTalents(filter);
+    });
+    TalentFilter locale;
+    locale.timezone = Symbol("UTC+1");
+    locale.preferredLanguage = Symbol("German");
+    bench.run("talent.findByLocale", scans, [&](std::size_t) { talents.findTalents(locale); });
+    TalentColumns columns;
+    bench.run("talent.refreshColumns", scans, [&](std::size_t) {
+        talents.updateAvailability(pick(data.talentIds), rng() % 2 == 0);
+        talents.refreshColumns(columns);
+    });
+    bench.run("talent.columnsAggregate", scans, [&](std::size_t) { columns.aggregate(filter); });
+    bench.run("talent.remove", points, [&](std::size_t i) { talents.removeTalent(created[i]); });
+
+    // Resources
+    bench.run("resource.add", points, [&](std::size_t i) {
+        created[i] = resources.addResource(generator.resource(scale + i));
+    });
+    bench.run("resource.get", points, [&](std::size_t) { resources.getResource(pick(data.resourceIds)); });
+    bench.run("resource.find", points, [&](std::size_t) { resources.findResource(pick(data.resourceIds)); });
+    bench.run("resource.with", points, [&](std::size_t) {
+        resources.withResource(pick(data.resourceIds), [](const Resource&) {});
+    });
+    bench.run("resource.update", points, [&](std::size_t i) {
+        resources.updateResource(created[i], generator.resource(i));
+    });
+    bench.run("resource.updateAvailability", points, [&](std::size_t) {
+        resources.updateResourceAvailability(pick(created), true);
+    });
+    bench.run("resource.available", scans, [&](std::size_t) { resources.getAvailableResources(); });
+    bench.run("resource.byType", scans, [&](std::size_t) { resources.getResourcesByType("studio"); });
+    bench.run("resource.isFree", points, [&](std::size_t) {
+        auto start = now + std::chrono::hours(rng() % (24 * 90));
+        resources.isResourceFree(pick(data.resourceIds), start, start + std::chrono::hours(48));
+    });
+    bench.run("resource.findFree", scans, [&](std::size_t) {
+        auto start = now + std::chrono::hours(rng() % (24 * 90));
+        resources.findFreeResources("camera", start, start + std::chrono::hours(48));
+    });
+
+    // Allocation cost grows with the candidate pools, so it runs a scan-sized
+    // count; half of the projects at most take single allocations, the rest
+    // batches
+    std::size_t allocations = std::min({points, scans * 10, data.projectIds.size() / 2});
+    bench.run("resource.compileAllocation", points, [&](std::size_t) {
+        ResourceAllocator::compileAllocation(generator.allocationRequest(pick(data.projectIds)));
+    });
+    bench.run("resource.allocate", allocations, [&](std::size_t i) {
+        resources.allocateResources(generator.allocationRequest(data.projectIds[i]));
+    });
+    bench.run("resource.byProject", std::min(scans, allocations), [&](std::size_t i) {
+        resources.getResourcesByProject(data.projectIds[i]);
+    });
+    std::vector<AllocationRequest> batch(16);
+    std::size_t batches = std::min(scans, (data.projectIds.size() - allocations) / batch.size());
+    bench.run("resource.allocateBatch16", batches, [&](std::size_t i) {
+        for (std::size_t r = 0; r < batch.size(); ++r) {
+            batch[r] = generator.allocationRequest(data.projectIds[allocations + i * batch.size() + r]);
+        }
+        resources.allocateResourcesBatch(batch);
+    });
+    bench.run("resource.optimize", scans, [&](std::size_t) { resources.optimizeResourceAllocation(); });
+    bench.run("resource.underutilized", scans, [&](std::size_t) { resources.getUnderutilizedResources(); });
+    bench.run("resource.overutilized", scans, [&](std::size_t) { resources.getOverutilizedResources(); });
+    bench.run("resource.utilization", points, [&](std::size_t) {
+        auto start = now + std::chrono::hours(rng() % (24 * 90));
+        resources.getResourceUtilization(pick(data.resourceIds), start, start + std::chrono::hours(24 * 30));
+    });
+    bench.run("resource.deallocate", allocations, [&](std::size_t i) {
+        resources.deallocateResources(data.projectIds[i]);
+    });
+    bench.run("resource.remove", points, [&](std::size_t i) { resources.removeResource(created[i]); });
+
+    if (feed) {
+        ChangeSubscription subscription = feed->subscribe();
+        std::vector<ChangeEvent> events;
+        events.reserve(256);
+        bench.run("feed.poll", points, [&](std::size_t) {
+            events.clear();
+            subscription.poll(events, events.capacity());
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+    BenchRunner::printHeader(options);
+    for (std::size_t scale : options.scales) {
+        runScale(options, scale);
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace imagined {
+
+// Members of each project, keyed by project ID: the reverse of a member's own
+// list of projects, so the members of one project are found, checked and torn
+// down in time proportional to their number instead of a scan over every
+// member. Projects are split over independently locked stripes by ID hash.
+//
+// Each stripe mutex is a leaf: it may be taken while holding a manager's
+// shard lock, and nothing is called while it is held. The index is only as
+// consistent as its callers make it; they link and unlink under the lock of
+// the member that gains or loses the project, and whoever reads members back
+// rechecks them under that same lock.
+template <typename Member, typename MemberHash = std::hash<Member>>
+class AssignmentIndex {
+public:
+    explicit AssignmentIndex(std::size_t stripeCount = 16,
+                             std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+        stripes_.reserve(stripeCount);
+        for (std::size_t i = 0; i < stripeCount; ++i) {
+            stripes_.push_back(std::make_unique<Stripe>(resource));
+        }
+    }
+
+    // Returns false if the member was already linked
+    bool link(const std::string& projectId, Member member) {
+        Stripe& stripe = stripeFor(projectId);
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        return stripe.members[projectId].insert(member).second;
+    }
+
+    // Returns false if the member was not linked
+    bool unlink(const std::string& projectId, Member member) {
+        Stripe& stripe = stripeFor(projectId);
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.members.find(projectId);
+        if (it == stripe.members.end() || it->second.erase(member) == 0) {
+            return false;
+        }
+        if (it->second.empty()) {
+            stripe.members.erase(it);
+        }
+        return true;
+    }
+
+    bool contains(const std::string& projectId, Member member) const {
+        const Stripe& stripe = stripeFor(projectId);
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.members.find(projectId);
+        return it != stripe.members.end() && it->second.count(member) > 0;
+    }
+
+    // Copy of the project's members, to be visited without the stripe lock
+    std::vector<Member> members(const std::string& projectId) const {
+        const Stripe& stripe = stripeFor(projectId);
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.members.find(projectId);
+        if (it == stripe.members.end()) {
+            return {};
+        }
+        return std::vector<Member>(it->second.begin(), it->second.end());
+    }
+
+private:
+    using MemberSet = std::pmr::unordered_set<Member, MemberHash>;
+
+    struct Stripe {
+        explicit Stripe(std::pmr::memory_resource* resource) : members(resource) {}
+
+        mutable std::shared_mutex mutex;
+        std::pmr::unordered_map<std::string, MemberSet> members;
+    };
+
+    std::vector<std::unique_ptr<Stripe>> stripes_;
+
+    Stripe& stripeFor(const std::string& projectId) {
+        return *stripes_[std::hash<std::string>()(projectId) % stripes_.size()];
+    }
+    const Stripe& stripeFor(const std::string& projectId) const {
+        return *stripes_[std::hash<std::string>()(projectId) % stripes_.size()];
+    }
+};
+
+} // namespace imagined
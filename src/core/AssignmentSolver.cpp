@@ -0,0 +1,168 @@
+#include "AssignmentSolver.hpp"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace imagined {
+
+namespace {
+
+// Primal-dual min-cost flow: Dijkstra on reduced costs prices the residual
+// graph, then every augmenting path made of zero reduced-cost edges is
+// pushed before pricing again, so one shortest-path run serves many units.
+class FlowGraph {
+public:
+    explicit FlowGraph(std::size_t nodeCount)
+        : adjacency_(nodeCount), potential_(nodeCount, 0.0), visited_(nodeCount, false) {}
+
+    std::size_t addEdge(std::size_t from, std::size_t to, std::size_t capacity, double cost) {
+        std::size_t index = edges_.size();
+        edges_.push_back(Edge{to, capacity, cost});
+        adjacency_[from].push_back(index);
+        edges_.push_back(Edge{from, 0, -cost});
+        adjacency_[to].push_back(index + 1);
+        return index;
+    }
+
+    bool saturated(std::size_t edge) const { return edges_[edge].capacity == 0; }
+
+    // Sends flow along cheapest paths until the sink is unreachable or
+    // `limit` units have been sent
+    void run(std::size_t source, std::size_t sink, std::size_t limit) {
+        std::size_t sent = 0;
+        while (sent < limit && updatePotentials(source, sink)) {
+            std::size_t pushed;
+            do {
+                std::fill(visited_.begin(), visited_.end(), false);
+                pushed = augment(source, sink, limit - sent);
+                sent += pushed;
+            } while (pushed > 0 && sent < limit);
+        }
+    }
+
+private:
+    struct Edge {
+        std::size_t to;
+        std::size_t capacity;
+        double cost;
+    };
+
+    static constexpr double kTolerance = 1e-9;
+
+    double reducedCost(std::size_t from, const Edge& edge) const {
+        return edge.cost + potential_[from] - potential_[edge.to];
+    }
+
+    // Dijkstra on reduced costs; returns false when the sink is unreachable
+    bool updatePotentials(std::size_t source, std::size_t sink) {
+        const double infinity = std::numeric_limits<double>::infinity();
+        std::vector<double> distance(adjacency_.size(), infinity);
+        distance[source] = 0.0;
+
+        using QueueEntry = std::pair<double, std::size_t>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+        queue.push({0.0, source});
+        while (!queue.empty()) {
+            auto [dist, node] = queue.top();
+            queue.pop();
+            if (dist > distance[node]) {
+                continue;
+            }
+            if (node == sink) {
+                break;
+            }
+            for (std::size_t index : adjacency_[node]) {
+                const Edge& edge = edges_[index];
+                if (edge.capacity == 0) {
+                    continue;
+                }
+                double next = dist + std::max(0.0, reducedCost(node, edge));
+                if (next < distance[edge.to]) {
+                    distance[edge.to] = next;
+                    queue.push({next, edge.to});
+                }
+            }
+        }
+
+        if (distance[sink] == infinity) {
+            return false;
+        }
+        // Capping at the sink's distance keeps reduced costs non-negative for
+        // nodes the search did not settle
+        for (std::size_t node = 0; node < adjacency_.size(); ++node) {
+            potential_[node] += std::min(distance[node], distance[sink]);
+        }
+        return true;
+    }
+
+    // Pushes up to `amount` units from `node` to the sink over edges with zero
+    // reduced cost, visiting each node at most once
+    std::size_t augment(std::size_t node, std::size_t sink, std::size_t amount) {
+        if (node == sink) {
+            return amount;
+        }
+        visited_[node] = true;
+        std::size_t pushed = 0;
+        for (std::size_t index : adjacency_[node]) {
+            Edge& edge = edges_[index];
+            if (edge.capacity == 0 || visited_[edge.to] || reducedCost(node, edge) > kTolerance) {
+                continue;
+            }
+            std::size_t sent = augment(edge.to, sink, std::min(amount - pushed, edge.capacity));
+            if (sent > 0) {
+                edge.capacity -= sent;
+                edges_[index ^ 1].capacity += sent;
+                pushed += sent;
+                if (pushed == amount) {
+                    break;
+                }
+            }
+        }
+        return pushed;
+    }
+
+    std::vector<Edge> edges_;
+    std::vector<std::vector<std::size_t>> adjacency_;
+    std::vector<double> potential_;
+    std::vector<bool> visited_;
+};
+
+} // namespace
+
+std::vector<std::vector<std::size_t>> solveMinCostAssignment(const AssignmentProblem& problem) {
+    const std::size_t requestCount = problem.demand.size();
+    const std::size_t source = 0;
+    const std::size_t firstRequest = 1;
+    const std::size_t firstTalent = firstRequest + requestCount;
+    const std::size_t sink = firstTalent + problem.talentCount;
+
+    FlowGraph graph(sink + 1);
+    std::size_t totalDemand = 0;
+    for (std::size_t r = 0; r < requestCount; ++r) {
+        graph.addEdge(source, firstRequest + r, problem.demand[r], 0.0);
+        totalDemand += problem.demand[r];
+    }
+    std::vector<std::size_t> pairingEdges;
+    pairingEdges.reserve(problem.edges.size());
+    for (const auto& edge : problem.edges) {
+        pairingEdges.push_back(graph.addEdge(firstRequest + edge.request, firstTalent + edge.talent,
+                                             1, edge.cost));
+    }
+    for (std::size_t t = 0; t < problem.talentCount; ++t) {
+        graph.addEdge(firstTalent + t, sink, 1, 0.0);
+    }
+
+    graph.run(source, sink, totalDemand);
+
+    std::vector<std::vector<std::size_t>> assignment(requestCount);
+    for (std::size_t i = 0; i < problem.edges.size(); ++i) {
+        if (graph.saturated(pairingEdges[i])) {
+            assignment[problem.edges[i].request].push_back(problem.edges[i].talent);
+        }
+    }
+    return assignment;
+}
+
+} // namespace imagined
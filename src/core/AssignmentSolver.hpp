@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace imagined {
+
+// Candidate pairing of one request with one talent at a given cost
+struct AssignmentEdge {
+    std::size_t request;
+    std::size_t talent;
+    double cost;
+};
+
+// Request r needs demand[r] distinct talents, each talent can serve at most
+// one request, and only the listed edges are allowed.
+struct AssignmentProblem {
+    std::vector<std::size_t> demand;
+    std::size_t talentCount = 0;
+    std::vector<AssignmentEdge> edges;
+};
+
+// Solves the problem as a primal-dual min-cost max-flow: as many seats as
+// possible are filled, at minimum total cost for that number. Returns the chosen talents of each request; a
+// request that cannot be fully staffed gets fewer than demand[r].
+// Edge costs must be non-negative.
+std::vector<std::vector<std::size_t>> solveMinCostAssignment(const AssignmentProblem& problem);
+
+} // namespace imagined
@@ -0,0 +1,71 @@
+#include "BookingCalendar.hpp"
+
+namespace imagined {
+
+bool BookingCalendar::isFree(const TimePoint& startDate, const TimePoint& endDate) const {
+    if (!(startDate < endDate)) {
+        return false;
+    }
+
+    // The only booking that can overlap is the last one starting before endDate
+    auto it = bookings_.lower_bound(endDate);
+    if (it == bookings_.begin()) {
+        return true;
+    }
+    --it;
+    return it->second.endDate <= startDate;
+}
+
+bool BookingCalendar::book(const TimePoint& startDate, const TimePoint& endDate,
+                           const std::string& projectId) {
+    if (!isFree(startDate, endDate)) {
+        return false;
+    }
+    bookings_.emplace(startDate, Booking{startDate, endDate, projectId});
+    return true;
+}
+
+bool BookingCalendar::release(const TimePoint& startDate) {
+    return bookings_.erase(startDate) > 0;
+}
+
+std::size_t BookingCalendar::releaseProject(const std::string& projectId) {
+    std::size_t released = 0;
+    for (auto it = bookings_.begin(); it != bookings_.end();) {
+        if (it->second.projectId == projectId) {
+            it = bookings_.erase(it);
+            ++released;
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
+
+bool BookingCalendar::hasProject(const std::string& projectId) const {
+    for (const auto& pair : bookings_) {
+        if (pair.second.projectId == projectId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const Booking* BookingCalendar::bookingAt(const TimePoint& when) const {
+    auto it = bookings_.upper_bound(when);
+    if (it == bookings_.begin()) {
+        return nullptr;
+    }
+    --it;
+    return when < it->second.endDate ? &it->second : nullptr;
+}
+
+void BookingCalendar::forEachBooking(const std::function<bool(const Booking&)>& visitor) const {
+    for (const auto& pair : bookings_) {
+        if (!visitor(pair.second)) {
+            break;
+        }
+    }
+}
+
+} // namespace imagined
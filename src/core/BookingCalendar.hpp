@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+
+namespace imagined {
+
+struct Booking {
+    std::chrono::system_clock::time_point startDate;
+    std::chrono::system_clock::time_point endDate;
+    std::string projectId;
+};
+
+// Non-overlapping [startDate, endDate) bookings of one resource, ordered by
+// start. Because bookings never overlap their end dates are ordered too, so
+// a free-window check only needs the booking just before the window's end.
+class BookingCalendar {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    explicit BookingCalendar(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : bookings_(resource) {}
+
+    bool isFree(const TimePoint& startDate, const TimePoint& endDate) const;
+    bool book(const TimePoint& startDate, const TimePoint& endDate, const std::string& projectId);
+    bool release(const TimePoint& startDate);
+    std::size_t releaseProject(const std::string& projectId);
+    bool hasProject(const std::string& projectId) const;
+    const Booking* bookingAt(const TimePoint& when) const;
+
+    void forEachBooking(const std::function<bool(const Booking&)>& visitor) const;
+    std::size_t size() const { return bookings_.size(); }
+    bool empty() const { return bookings_.empty(); }
+
+private:
+    std::pmr::map<TimePoint, Booking> bookings_;
+};
+
+} // namespace imagined
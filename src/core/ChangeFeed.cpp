@@ -0,0 +1,108 @@
+#include "ChangeFeed.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace imagined {
+
+ChangeFeed::ChangeFeed(std::size_t capacity) {
+    std::size_t rounded = 1;
+    while (rounded < std::max<std::size_t>(capacity, 2)) {
+        rounded <<= 1;
+    }
+    mask_ = rounded - 1;
+    slots_ = std::make_unique<Slot[]>(rounded);
+}
+
+std::uint64_t ChangeFeed::publish(ChangeEntity entity, ChangeType type, std::string_view id) {
+    std::uint64_t sequence = next_.fetch_add(1, std::memory_order_acq_rel);
+
+    WireEvent event{};
+    event.sequence = sequence;
+    event.entity = entity;
+    event.type = type;
+    if (id.size() <= ChangeEvent::kMaxIdLength) {
+        event.idLength = static_cast<std::uint8_t>(id.size());
+        std::memcpy(event.idBytes, id.data(), id.size());
+    } else {
+        event.idLength = ChangeEvent::kMaxIdLength + 1;
+    }
+    std::array<std::uint64_t, kWords> words;
+    std::memcpy(words.data(), &event, sizeof(event));
+
+    Slot& slot = slots_[sequence & mask_];
+    std::uint64_t previous = sequence > capacity() ? 2 * (sequence - capacity()) : 0;
+    while (slot.state.load(std::memory_order_acquire) != previous) {
+        std::this_thread::yield();
+    }
+    slot.state.store(2 * sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWords; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.state.store(2 * sequence, std::memory_order_release);
+    return sequence;
+}
+
+ChangeSubscription ChangeFeed::subscribe(std::uint64_t fromSequence) const {
+    return ChangeSubscription(*this, fromSequence == 0 ? oldestSequence() : fromSequence);
+}
+
+std::uint64_t ChangeFeed::oldestSequence() const {
+    std::uint64_t next = nextSequence();
+    return next > capacity() ? next - capacity() : 1;
+}
+
+ChangeFeed::ReadStatus ChangeFeed::read(std::uint64_t sequence, ChangeEvent& event) const {
+    const Slot& slot = slots_[sequence & mask_];
+    std::uint64_t before = slot.state.load(std::memory_order_acquire);
+    if (before > 2 * sequence) {
+        return ReadStatus::OVERWRITTEN;
+    }
+    if (before != 2 * sequence) {
+        return ReadStatus::PENDING;
+    }
+    std::array<std::uint64_t, kWords> words;
+    for (std::size_t i = 0; i < kWords; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // A producer a ring later may have started on the slot while it was copied
+    if (slot.state.load(std::memory_order_relaxed) != before) {
+        return ReadStatus::OVERWRITTEN;
+    }
+    WireEvent wire;
+    std::memcpy(&wire, words.data(), sizeof(wire));
+    event.sequence = wire.sequence;
+    event.entity = wire.entity;
+    event.type = wire.type;
+    event.idLength = wire.idLength;
+    std::memcpy(event.idBytes, wire.idBytes, sizeof(wire.idBytes));
+    return ReadStatus::READ;
+}
+
+std::size_t ChangeSubscription::poll(std::vector<ChangeEvent>& out, std::size_t maxEvents) {
+    std::size_t count = 0;
+    ChangeEvent event;
+    while (count < maxEvents) {
+        switch (feed_->read(next_, event)) {
+        case ChangeFeed::ReadStatus::READ:
+            out.push_back(event);
+            ++next_;
+            ++count;
+            break;
+        case ChangeFeed::ReadStatus::OVERWRITTEN: {
+            // Fell a ring behind; skip to the oldest event still retained
+            std::uint64_t oldest = std::max(feed_->oldestSequence(), next_ + 1);
+            missed_ += oldest - next_;
+            next_ = oldest;
+            break;
+        }
+        case ChangeFeed::ReadStatus::PENDING:
+            return count;
+        }
+    }
+    return count;
+}
+
+} // namespace imagined
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace imagined {
+
+enum class ChangeEntity : std::uint8_t {
+    PROJECT,
+    TALENT,
+    RESOURCE
+};
+
+// PUT: the entity was created or changed; read its new state by ID.
+// ERASE: the entity was removed.
+enum class ChangeType : std::uint8_t {
+    PUT,
+    ERASE
+};
+
+// One published change. Fixed-size so it fits a ring slot: the entity ID is
+// carried inline when it fits, which every generated UUID does. A longer ID,
+// only possible through restore*, is published without it; a consumer seeing
+// !hasId() has to rescan that entity kind.
+struct ChangeEvent {
+    static constexpr std::size_t kMaxIdLength = 61;
+
+    std::uint64_t sequence = 0;
+    ChangeEntity entity = ChangeEntity::PROJECT;
+    ChangeType type = ChangeType::PUT;
+    std::uint8_t idLength = 0;
+    char idBytes[kMaxIdLength] = {};
+
+    bool hasId() const { return idLength <= kMaxIdLength; }
+    std::string_view id() const { return hasId() ? std::string_view(idBytes, idLength) : std::string_view(); }
+};
+
+class ChangeFeed;
+
+// A consumer's position in a ChangeFeed. poll returns events in sequence
+// order starting at nextSequence(), so a consumer that stores nextSequence()
+// can resume from it with ChangeFeed::subscribe. A consumer that falls more
+// than the feed's capacity behind skips the events that were overwritten;
+// missed() counts them, and a nonzero value means the consumer's view must
+// be rebuilt from a full scan.
+class ChangeSubscription {
+public:
+    // Appends up to maxEvents events to `out` and returns how many
+    std::size_t poll(std::vector<ChangeEvent>& out,
+                     std::size_t maxEvents = std::numeric_limits<std::size_t>::max());
+
+    std::uint64_t nextSequence() const { return next_; }
+    std::uint64_t missed() const { return missed_; }
+
+private:
+    friend class ChangeFeed;
+    ChangeSubscription(const ChangeFeed& feed, std::uint64_t next) : feed_(&feed), next_(next) {}
+
+    const ChangeFeed* feed_;
+    std::uint64_t next_;
+    std::uint64_t missed_ = 0;
+};
+
+// Change-data-capture stream of the managers: each mutation publishes a
+// ChangeEvent with the next sequence number, starting at 1, into a ring of
+// fixed capacity. Attach one feed to the project, talent and resource
+// managers to get a single ordered stream of all three.
+//
+// Publishing takes no lock: a producer claims its sequence with one atomic
+// add and fills its slot, guarded by a per-slot version as in a seqlock.
+// Managers publish under the entity's shard write lock, so events of one
+// entity appear in mutation order. Readers never block producers; a reader
+// stops at the first sequence that is claimed but not filled yet, so every
+// subscriber sees the same order. A producer only waits when the previous
+// occupant of its slot, a full ring behind, is still being written.
+class ChangeFeed {
+public:
+    // Capacity is rounded up to a power of two
+    explicit ChangeFeed(std::size_t capacity = 65536);
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    std::uint64_t publish(ChangeEntity entity, ChangeType type, std::string_view id);
+
+    // Starts at `fromSequence`, or at the oldest retained event when zero
+    ChangeSubscription subscribe(std::uint64_t fromSequence = 0) const;
+
+    // Sequence the next published event will get
+    std::uint64_t nextSequence() const { return next_.load(std::memory_order_acquire); }
+    // Oldest sequence that may still be read
+    std::uint64_t oldestSequence() const;
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    friend class ChangeSubscription;
+
+    // Layout of a ChangeEvent in a slot. ChangeEvent itself has member
+    // initializers, so events are copied through this plain struct.
+    struct WireEvent {
+        std::uint64_t sequence;
+        ChangeEntity entity;
+        ChangeType type;
+        std::uint8_t idLength;
+        char idBytes[ChangeEvent::kMaxIdLength];
+    };
+    static_assert(std::is_trivially_copyable_v<WireEvent>, "WireEvent is copied as raw words");
+
+    static constexpr std::size_t kWords = sizeof(WireEvent) / sizeof(std::uint64_t);
+    static_assert(sizeof(WireEvent) % sizeof(std::uint64_t) == 0, "WireEvent must pack into words");
+
+    // state is 2 * sequence once the slot holds that event and one less
+    // while it is being written; zero for a slot never written
+    struct Slot {
+        std::atomic<std::uint64_t> state{0};
+        std::array<std::atomic<std::uint64_t>, kWords> words;
+    };
+
+    enum class ReadStatus {
+        READ,
+        PENDING,     // Not published yet
+        OVERWRITTEN  // Already replaced by an event a ring later
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<std::uint64_t> next_{1};
+
+    ReadStatus read(std::uint64_t sequence, ChangeEvent& event) const;
+};
+
+} // namespace imagined
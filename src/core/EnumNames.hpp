@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace imagined {
+
+// Lookup between an enum and a table of its enumerator names, indexed by
+// value. Parsing accepts a name, in any letter case, or the decimal value,
+// so text written either way reads back the same; it never throws. Both
+// directions are constexpr, so the tables are checked at compile time.
+
+constexpr char asciiUpper(char c) {
+    return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+constexpr bool equalsIgnoringCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (asciiUpper(a[i]) != asciiUpper(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Enum, std::size_t N>
+constexpr std::string_view enumName(Enum value, const std::array<std::string_view, N>& names) {
+    auto index = static_cast<std::size_t>(value);
+    return index < N ? names[index] : std::string_view();
+}
+
+template <typename Enum, std::size_t N>
+constexpr std::optional<Enum> parseEnumName(std::string_view text, const std::array<std::string_view, N>& names) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (equalsIgnoringCase(text, names[i])) {
+            return static_cast<Enum>(i);
+        }
+    }
+    if (text.empty() || text.size() > 9) {
+        return std::nullopt;
+    }
+    std::size_t index = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return std::nullopt;
+        }
+        index = index * 10 + static_cast<std::size_t>(c - '0');
+    }
+    if (index >= N) {
+        return std::nullopt;
+    }
+    return static_cast<Enum>(index);
+}
+
+} // namespace imagined
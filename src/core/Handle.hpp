@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace imagined {
+
+// Generational reference to a slot in a SlotMap. The slot index gives O(1)
+// lookup; a generation that no longer matches the slot means the entity it
+// referred to has been removed, even if the slot has been reused since.
+template <typename Tag>
+struct Handle {
+    static constexpr std::uint32_t kInvalidIndex = 0xFFFFFFFFu;
+
+    std::uint32_t index = kInvalidIndex;
+    std::uint32_t generation = 0;
+
+    constexpr bool valid() const { return index != kInvalidIndex; }
+
+    constexpr bool operator==(const Handle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    constexpr bool operator!=(const Handle& other) const { return !(*this == other); }
+    constexpr bool operator<(const Handle& other) const {
+        return index < other.index || (index == other.index && generation < other.generation);
+    }
+};
+
+struct HandleHash {
+    template <typename Tag>
+    std::size_t operator()(const Handle<Tag>& handle) const {
+        return std::hash<std::uint64_t>()((static_cast<std::uint64_t>(handle.generation) << 32) |
+                                          handle.index);
+    }
+};
+
+struct ProjectTag;
+struct TalentTag;
+struct ResourceTag;
+
+using ProjectHandle = Handle<ProjectTag>;
+using TalentHandle = Handle<TalentTag>;
+using ResourceHandle = Handle<ResourceTag>;
+
+} // namespace imagined
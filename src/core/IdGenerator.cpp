@@ -0,0 +1,65 @@
+#include "IdGenerator.hpp"
+#include <cstdint>
+#include <random>
+
+namespace imagined {
+
+namespace {
+
+class Xoshiro256 {
+public:
+    Xoshiro256() {
+        std::random_device rd;
+        std::uint64_t seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+        for (auto& word : state_) {
+            word = splitMix64(seed);
+        }
+    }
+
+    std::uint64_t next() {
+        const std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const std::uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+private:
+    std::uint64_t state_[4];
+
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static std::uint64_t splitMix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+} // namespace
+
+std::string generateUuid() {
+    thread_local Xoshiro256 generator;
+    static const char* hex = "0123456789abcdef";
+
+    std::uint64_t bits[2] = {generator.next(), generator.next()};
+    std::string uuid(36, '-');
+    int nibble = 0;
+    for (int i = 0; i < 36; i++) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            continue;
+        }
+        uuid[i] = hex[(bits[nibble / 16] >> ((nibble % 16) * 4)) & 0xF];
+        ++nibble;
+    }
+    return uuid;
+}
+
+} // namespace imagined
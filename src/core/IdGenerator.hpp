@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+namespace imagined {
+
+// Returns a random 36-character UUID-formatted ID. Each thread owns a
+// xoshiro256** generator seeded once from std::random_device, so repeated
+// calls cost a few arithmetic ops and no system calls.
+std::string generateUuid();
+
+} // namespace imagined
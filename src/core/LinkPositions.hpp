@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace imagined {
+
+// Position of every ID in an entity's link vector (a project's
+// assignedTeamMembers, a talent's completedProjects), kept beside the vector
+// so a link is checked, added or removed in O(1). Removing an ID moves the
+// vector's last ID into its place.
+using LinkPositions = std::pmr::unordered_map<std::string, std::uint32_t>;
+
+// Rebuilds `positions` from `ids`, dropping repeats of an ID from `ids`
+inline void indexLinks(LinkPositions& positions, std::vector<std::string>& ids) {
+    positions.clear();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        if (!positions.emplace(ids[i], static_cast<std::uint32_t>(kept)).second) {
+            continue;
+        }
+        if (kept != i) {
+            ids[kept] = std::move(ids[i]);
+        }
+        ++kept;
+    }
+    ids.resize(kept);
+}
+
+// Returns false if the ID was already linked
+inline bool addLink(LinkPositions& positions, std::vector<std::string>& ids, const std::string& id) {
+    if (!positions.emplace(id, static_cast<std::uint32_t>(ids.size())).second) {
+        return false;
+    }
+    ids.push_back(id);
+    return true;
+}
+
+// Returns false if the ID was not linked
+inline bool removeLink(LinkPositions& positions, std::vector<std::string>& ids, const std::string& id) {
+    auto it = positions.find(id);
+    if (it == positions.end()) {
+        return false;
+    }
+    std::uint32_t position = it->second;
+    positions.erase(it);
+    if (position + 1 != ids.size()) {
+        ids[position] = std::move(ids.back());
+        positions.find(ids[position])->second = position;
+    }
+    ids.pop_back();
+    return true;
+}
+
+// IDs linked in `after` but not in `before` go to `added`, the reverse to
+// `removed`; a null side has no links
+inline void diffLinks(const LinkPositions* before, const LinkPositions* after,
+                      std::vector<std::string>& added, std::vector<std::string>& removed) {
+    if (after != nullptr) {
+        for (const auto& link : *after) {
+            if (before == nullptr || before->count(link.first) == 0) {
+                added.push_back(link.first);
+            }
+        }
+    }
+    if (before != nullptr) {
+        for (const auto& link : *before) {
+            if (after == nullptr || after->count(link.first) == 0) {
+                removed.push_back(link.first);
+            }
+        }
+    }
+}
+
+} // namespace imagined
@@ -0,0 +1,293 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace imagined {
+
+namespace {
+
+constexpr std::array<const char*, kOperationCount> kOperationNames = {
+    // ProjectManager
+    "ProjectManager::createProject",
+    "ProjectManager::updateProject",
+    "ProjectManager::deleteProject",
+    "ProjectManager::getProject",
+    "ProjectManager::findProject",
+    "ProjectManager::withProject",
+    "ProjectManager::containsProject",
+    "ProjectManager::projectCount",
+    "ProjectManager::findProjectHandle",
+    "ProjectManager::restoreProject",
+    "ProjectManager::forEachProject",
+    "ProjectManager::updateProjectStatus",
+    "ProjectManager::getProjectsByStatus",
+    "ProjectManager::forEachProjectWithStatus",
+    "ProjectManager::assignTeamMember",
+    "ProjectManager::removeTeamMember",
+    "ProjectManager::assignTeamMembers",
+    "ProjectManager::getProjectsByClient",
+    "ProjectManager::getProjectsByType",
+    "ProjectManager::forEachProjectOfClient",
+    "ProjectManager::forEachProjectOfType",
+    "ProjectManager::getUpcomingDeadlines",
+    "ProjectManager::getUpcomingDeadlinesPage",
+    "ProjectManager::forEachUpcomingDeadline",
+    // TalentManager
+    "TalentManager::addTalent",
+    "TalentManager::updateTalent",
+    "TalentManager::removeTalent",
+    "TalentManager::getTalent",
+    "TalentManager::findTalent",
+    "TalentManager::withTalent",
+    "TalentManager::containsTalent",
+    "TalentManager::talentCount",
+    "TalentManager::findTalentHandle",
+    "TalentManager::restoreTalent",
+    "TalentManager::addSkill",
+    "TalentManager::removeSkill",
+    "TalentManager::getTalentsBySkill",
+    "TalentManager::findAvailableTalentsWithSkills",
+    "TalentManager::forEachTalentWithSkill",
+    "TalentManager::forEachAvailableTalentWithSkills",
+    "TalentManager::findAvailableCandidates",
+    "TalentManager::forEachAvailableCandidate",
+    "TalentManager::findRankedCandidates",
+    "TalentManager::commitProjectAssignment",
+    "TalentManager::updateAvailability",
+    "TalentManager::getAvailableTalents",
+    "TalentManager::forEachAvailableTalent",
+    "TalentManager::assignProject",
+    "TalentManager::removeProject",
+    "TalentManager::getTalentProjects",
+    "TalentManager::findTalentProjects",
+    "TalentManager::searchTalents",
+    "TalentManager::forEachTalentMatching",
+    "TalentManager::getTalentsByExperienceLevel",
+    "TalentManager::getTalentsByHourlyRateRange",
+    "TalentManager::findTalents",
+    "TalentManager::forEachTalent",
+    "TalentManager::refreshColumns",
+    // ResourceAllocator
+    "ResourceAllocator::addResource",
+    "ResourceAllocator::updateResource",
+    "ResourceAllocator::removeResource",
+    "ResourceAllocator::getResource",
+    "ResourceAllocator::findResource",
+    "ResourceAllocator::withResource",
+    "ResourceAllocator::resourceCount",
+    "ResourceAllocator::findResourceHandle",
+    "ResourceAllocator::restoreResource",
+    "ResourceAllocator::forEachResource",
+    "ResourceAllocator::allocateResources",
+    "ResourceAllocator::allocateResourcesBatch",
+    "ResourceAllocator::deallocateResources",
+    "ResourceAllocator::updateResourceAvailability",
+    "ResourceAllocator::getAvailableResources",
+    "ResourceAllocator::forEachAvailableResource",
+    "ResourceAllocator::isResourceFree",
+    "ResourceAllocator::findFreeResources",
+    "ResourceAllocator::findBookingCalendar",
+    "ResourceAllocator::getResourcesByProject",
+    "ResourceAllocator::getResourcesByType",
+    "ResourceAllocator::forEachResourceOfProject",
+    "ResourceAllocator::forEachResourceOfType",
+    "ResourceAllocator::optimizeResourceAllocation",
+    "ResourceAllocator::getUnderutilizedResources",
+    "ResourceAllocator::getOverutilizedResources",
+    "ResourceAllocator::getResourceUtilization",};
+
+static_assert(static_cast<std::size_t>(OperationId::GET_RESOURCE_UTILIZATION) + 1 == kOperationCount,
+              "kOperationCount must match OperationId");
+
+// Written only by the owning thread, read by snapshot() from any thread
+struct ThreadOperation {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> totalNanoseconds{0};
+    std::atomic<std::uint64_t> resultItems{0};
+    std::atomic<std::uint64_t> heapAllocations{0};
+    std::array<std::atomic<std::uint64_t>, LatencyHistogram::kBucketCount> buckets{};
+};
+
+// Single writer, so a load and a store replace a locked read-modify-write
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void collect(const ThreadOperation& from, OperationStats& into) {
+    into.calls += from.calls.load(std::memory_order_relaxed);
+    into.totalNanoseconds += from.totalNanoseconds.load(std::memory_order_relaxed);
+    into.resultItems += from.resultItems.load(std::memory_order_relaxed);
+    into.heapAllocations += from.heapAllocations.load(std::memory_order_relaxed);
+    for (std::size_t b = 0; b < LatencyHistogram::kBucketCount; ++b) {
+        into.latency.buckets[b] += from.buckets[b].load(std::memory_order_relaxed);
+    }
+}
+
+class ThreadMetrics;
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadMetrics*> threads;
+    std::vector<OperationStats> retired;
+
+    Registry() : retired(kOperationCount) {
+        for (std::size_t i = 0; i < kOperationCount; ++i) {
+            retired[i].operation = static_cast<OperationId>(i);
+            retired[i].name = kOperationNames[i];
+        }
+    }
+};
+
+// Never destroyed, so threads exiting during shutdown can still retire
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+class ThreadMetrics {
+public:
+    ThreadMetrics() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.threads.push_back(this);
+    }
+
+    ~ThreadMetrics() {
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        collectInto(shared.retired);
+        shared.threads.erase(std::find(shared.threads.begin(), shared.threads.end(), this));
+        for (auto& slot : operations_) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    ThreadOperation& operation(OperationId id) {
+        auto& slot = operations_[static_cast<std::size_t>(id)];
+        ThreadOperation* counters = slot.load(std::memory_order_relaxed);
+        if (counters == nullptr) {
+            counters = new ThreadOperation();
+            slot.store(counters, std::memory_order_release);
+        }
+        return *counters;
+    }
+
+    void collectInto(std::vector<OperationStats>& stats) const {
+        for (std::size_t i = 0; i < kOperationCount; ++i) {
+            if (const ThreadOperation* counters = operations_[i].load(std::memory_order_acquire)) {
+                collect(*counters, stats[i]);
+            }
+        }
+    }
+
+private:
+    std::array<std::atomic<ThreadOperation*>, kOperationCount> operations_{};
+};
+
+ThreadMetrics& threadMetrics() {
+    thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+} // namespace
+
+const char* operationName(OperationId operation) {
+    return kOperationNames[static_cast<std::size_t>(operation)];
+}
+
+std::size_t LatencyHistogram::bucketFor(std::uint64_t nanoseconds) {
+    constexpr std::uint64_t kExact = std::uint64_t(1) << kSubBucketBits;
+    if (nanoseconds < kExact) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+    unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(nanoseconds));
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+    auto subBucket = static_cast<std::size_t>((nanoseconds >> (exponent - kSubBucketBits)) & (kExact - 1));
+    return (std::size_t(exponent - kSubBucketBits + 1) << kSubBucketBits) + subBucket;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) {
+    constexpr std::size_t kExact = std::size_t(1) << kSubBucketBits;
+    if (bucket < kExact) {
+        return bucket;
+    }
+    unsigned exponent = static_cast<unsigned>(bucket >> kSubBucketBits) + kSubBucketBits - 1;
+    std::uint64_t width = std::uint64_t(1) << (exponent - kSubBucketBits);
+    std::uint64_t lower = (kExact + (bucket & (kExact - 1))) * width;
+    return lower + width - 1;
+}
+
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    for (std::size_t b = 0; b < kBucketCount; ++b) {
+        buckets[b] += other.buckets[b];
+    }
+}
+
+std::uint64_t LatencyHistogram::count() const {
+    std::uint64_t total = 0;
+    for (std::uint64_t bucket : buckets) {
+        total += bucket;
+    }
+    return total;
+}
+
+std::uint64_t LatencyHistogram::percentile(double quantile) const {
+    std::uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBucketCount; ++b) {
+        seen += buckets[b];
+        if (seen >= rank) {
+            return bucketUpperBound(b);
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1);
+}
+
+const OperationStats* MetricsSnapshot::find(OperationId operation) const {
+    for (const auto& stats : operations) {
+        if (stats.operation == operation) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+MetricsSnapshot Metrics::snapshot() {
+    Registry& shared = registry();
+    std::vector<OperationStats> totals;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        totals = shared.retired;
+        for (const ThreadMetrics* thread : shared.threads) {
+            thread->collectInto(totals);
+        }
+    }
+
+    MetricsSnapshot snapshot;
+    for (auto& stats : totals) {
+        if (stats.calls > 0) {
+            snapshot.operations.push_back(std::move(stats));
+        }
+    }
+    return snapshot;
+}
+
+void Metrics::record(OperationId operation, std::uint64_t nanoseconds, std::uint64_t resultItems,
+                     std::uint64_t heapAllocations) {
+    ThreadOperation& counters = threadMetrics().operation(operation);
+    bump(counters.calls, 1);
+    bump(counters.totalNanoseconds, nanoseconds);
+    bump(counters.resultItems, resultItems);
+    bump(counters.heapAllocations, heapAllocations);
+    bump(counters.buckets[LatencyHistogram::bucketFor(nanoseconds)], 1);
+}
+
+} // namespace imagined
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace imagined {
+
+// One entry per public manager method; overloads share an entry
+enum class OperationId : std::uint16_t {
+    // ProjectManager
+    CREATE_PROJECT,
+    UPDATE_PROJECT,
+    DELETE_PROJECT,
+    GET_PROJECT,
+    FIND_PROJECT,
+    WITH_PROJECT,
+    CONTAINS_PROJECT,
+    PROJECT_COUNT,
+    FIND_PROJECT_HANDLE,
+    RESTORE_PROJECT,
+    FOR_EACH_PROJECT,
+    UPDATE_PROJECT_STATUS,
+    GET_PROJECTS_BY_STATUS,
+    FOR_EACH_PROJECT_WITH_STATUS,
+    ASSIGN_TEAM_MEMBER,
+    REMOVE_TEAM_MEMBER,
+    ASSIGN_TEAM_MEMBERS,
+    GET_PROJECTS_BY_CLIENT,
+    GET_PROJECTS_BY_TYPE,
+    FOR_EACH_PROJECT_OF_CLIENT,
+    FOR_EACH_PROJECT_OF_TYPE,
+    GET_UPCOMING_DEADLINES,
+    GET_UPCOMING_DEADLINES_PAGE,
+    FOR_EACH_UPCOMING_DEADLINE,
+
+    // TalentManager
+    ADD_TALENT,
+    UPDATE_TALENT,
+    REMOVE_TALENT,
+    GET_TALENT,
+    FIND_TALENT,
+    WITH_TALENT,
+    CONTAINS_TALENT,
+    TALENT_COUNT,
+    FIND_TALENT_HANDLE,
+    RESTORE_TALENT,
+    ADD_SKILL,
+    REMOVE_SKILL,
+    GET_TALENTS_BY_SKILL,
+    FIND_AVAILABLE_TALENTS_WITH_SKILLS,
+    FOR_EACH_TALENT_WITH_SKILL,
+    FOR_EACH_AVAILABLE_TALENT_WITH_SKILLS,
+    FIND_AVAILABLE_CANDIDATES,
+    FOR_EACH_AVAILABLE_CANDIDATE,
+    FIND_RANKED_CANDIDATES,
+    COMMIT_PROJECT_ASSIGNMENT,
+    UPDATE_AVAILABILITY,
+    GET_AVAILABLE_TALENTS,
+    FOR_EACH_AVAILABLE_TALENT,
+    ASSIGN_PROJECT,
+    REMOVE_PROJECT,
+    GET_TALENT_PROJECTS,
+    FIND_TALENT_PROJECTS,
+    SEARCH_TALENTS,
+    FOR_EACH_TALENT_MATCHING,
+    GET_TALENTS_BY_EXPERIENCE_LEVEL,
+    GET_TALENTS_BY_HOURLY_RATE_RANGE,
+    FIND_TALENTS,
+    FOR_EACH_TALENT,
+    REFRESH_COLUMNS,
+
+    // ResourceAllocator
+    ADD_RESOURCE,
+    UPDATE_RESOURCE,
+    REMOVE_RESOURCE,
+    GET_RESOURCE,
+    FIND_RESOURCE,
+    WITH_RESOURCE,
+    RESOURCE_COUNT,
+    FIND_RESOURCE_HANDLE,
+    RESTORE_RESOURCE,
+    FOR_EACH_RESOURCE,
+    ALLOCATE_RESOURCES,
+    ALLOCATE_RESOURCES_BATCH,
+    DEALLOCATE_RESOURCES,
+    UPDATE_RESOURCE_AVAILABILITY,
+    GET_AVAILABLE_RESOURCES,
+    FOR_EACH_AVAILABLE_RESOURCE,
+    IS_RESOURCE_FREE,
+    FIND_FREE_RESOURCES,
+    FIND_BOOKING_CALENDAR,
+    GET_RESOURCES_BY_PROJECT,
+    GET_RESOURCES_BY_TYPE,
+    FOR_EACH_RESOURCE_OF_PROJECT,
+    FOR_EACH_RESOURCE_OF_TYPE,
+    OPTIMIZE_RESOURCE_ALLOCATION,
+    GET_UNDERUTILIZED_RESOURCES,
+    GET_OVERUTILIZED_RESOURCES,
+    GET_RESOURCE_UTILIZATION
+};
+
+constexpr std::size_t kOperationCount = 85;
+
+// "Class::method"
+const char* operationName(OperationId operation);
+
+// Log-linear latency histogram in the style of HdrHistogram: values below 8ns
+// get exact buckets and every power of two above is split into 8 sub-buckets,
+// so a bucket's upper bound overstates a value by at most 12.5%.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr unsigned kMaxExponent = 42;  // About 73 minutes
+    static constexpr std::size_t kBucketCount = std::size_t(kMaxExponent - kSubBucketBits + 2) << kSubBucketBits;
+
+    static std::size_t bucketFor(std::uint64_t nanoseconds);
+    static std::uint64_t bucketUpperBound(std::size_t bucket);
+
+    void add(const LatencyHistogram& other);
+    std::uint64_t count() const;
+    // Upper bound in nanoseconds of the bucket holding the quantile, e.g.
+    // 0.99 for p99; 0 when empty
+    std::uint64_t percentile(double quantile) const;
+
+    std::array<std::uint64_t, kBucketCount> buckets{};
+};
+
+struct OperationStats {
+    OperationId operation;
+    const char* name;
+    std::uint64_t calls = 0;
+    std::uint64_t totalNanoseconds = 0;
+    std::uint64_t resultItems = 0;      // Elements returned by collection-returning methods
+    std::uint64_t heapAllocations = 0;  // Only counted when the allocation hook is linked
+    LatencyHistogram latency;
+
+    double meanNanoseconds() const {
+        return calls == 0 ? 0.0 : static_cast<double>(totalNanoseconds) / static_cast<double>(calls);
+    }
+};
+
+// Cumulative since the process started; diff two snapshots for rates
+struct MetricsSnapshot {
+    std::vector<OperationStats> operations;  // Only operations called at least once
+
+    const OperationStats* find(OperationId operation) const;
+};
+
+// Opt-in instrumentation of every public ProjectManager, TalentManager and
+// ResourceAllocator call. While disabled, the default, a call costs one
+// relaxed atomic load. Enabled, each thread records into its own counters
+// and histogram with plain stores, and snapshot() merges all threads under a
+// registry lock; the counts of exited threads are kept in a retired total.
+//
+// Only the outermost instrumented call on a thread is recorded, so a method
+// delegating to another public method, or the allocator calling into the
+// talent manager, counts once, as the call the application made.
+//
+// Heap allocations are counted through a replacement global operator new,
+// which the library does not install by itself: link the
+// imagined_studio_alloc_counter object library into the executable.
+class Metrics {
+public:
+    static void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static MetricsSnapshot snapshot();
+
+    static void record(OperationId operation, std::uint64_t nanoseconds, std::uint64_t resultItems,
+                       std::uint64_t heapAllocations);
+
+    // Called by the allocation hook
+    static void countHeapAllocation() { ++heapAllocations_; }
+    static std::uint64_t heapAllocations() { return heapAllocations_; }
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+    static inline thread_local std::uint64_t heapAllocations_ = 0;
+};
+
+// Declared at the top of an instrumented method
+class OperationScope {
+public:
+    explicit OperationScope(OperationId operation) : operation_(operation) {
+        if (Metrics::enabled()) {
+            active_ = true;
+            outermost_ = depth_++ == 0;
+            if (outermost_) {
+                allocations_ = Metrics::heapAllocations();
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    ~OperationScope() {
+        if (active_) {
+            --depth_;
+            if (outermost_) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start_);
+                Metrics::record(operation_, static_cast<std::uint64_t>(elapsed.count()), resultItems_,
+                                Metrics::heapAllocations() - allocations_);
+            }
+        }
+    }
+
+    OperationScope(const OperationScope&) = delete;
+    OperationScope& operator=(const OperationScope&) = delete;
+
+    // Number of elements a collection-returning method hands back
+    void setResultSize(std::size_t items) { resultItems_ = items; }
+
+private:
+    OperationId operation_;
+    bool active_ = false;
+    bool outermost_ = false;
+    std::uint64_t resultItems_ = 0;
+    std::uint64_t allocations_ = 0;
+    std::chrono::steady_clock::time_point start_;
+
+    static inline thread_local unsigned depth_ = 0;
+};
+
+} // namespace imagined
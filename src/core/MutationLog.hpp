@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace imagined {
+
+struct Project;
+struct Talent;
+struct Resource;
+struct Booking;
+
+// Receives the full post-mutation state of every changed entity. The put and
+// erase calls are made under the entity's shard write lock, so records of one
+// entity arrive in mutation order; each returns a ticket. awaitDurable is
+// only called with no lock held and returns once the ticket is durable, or
+// throws if it never will be.
+class MutationLog {
+public:
+    virtual ~MutationLog() = default;
+
+    virtual std::uint64_t putProject(const Project& project) = 0;
+    virtual std::uint64_t eraseProject(const std::string& projectId) = 0;
+    virtual std::uint64_t putTalent(const Talent& talent) = 0;
+    virtual std::uint64_t eraseTalent(const std::string& talentId) = 0;
+    virtual std::uint64_t putResource(const Resource& resource, const std::vector<Booking>& bookings) = 0;
+    virtual std::uint64_t eraseResource(const std::string& resourceId) = 0;
+
+    virtual void awaitDurable(std::uint64_t ticket) = 0;
+};
+
+// Declared at the top of a mutating call, before any lock is taken. Tickets
+// noted while it is active are awaited when it goes out of scope, which is
+// after the call's locks have been released. Scopes nest per thread: an inner
+// scope on the same log hands its tickets to the outermost one, so calls made
+// while holding locks never wait for the disk.
+//
+// A log failure is thrown out of the mutating call from here, so the call
+// does not report success for a change that was lost. A scope left by an
+// exception does not wait; the call has failed already.
+class DurableScope {
+public:
+    explicit DurableScope(MutationLog* log)
+        : log_(log), outer_(active_), uncaught_(std::uncaught_exceptions()) {
+        if (log_ != nullptr && (outer_ == nullptr || outer_->log_ != log_)) {
+            owner_ = true;
+            active_ = this;
+        }
+    }
+
+    ~DurableScope() noexcept(false) {
+        if (owner_) {
+            active_ = outer_;
+            if (ticket_ != 0 && std::uncaught_exceptions() == uncaught_) {
+                log_->awaitDurable(ticket_);
+            }
+        }
+    }
+
+    DurableScope(const DurableScope&) = delete;
+    DurableScope& operator=(const DurableScope&) = delete;
+
+    // Adds a ticket to the innermost active scope of this thread
+    static void note(std::uint64_t ticket) {
+        if (active_ != nullptr) {
+            active_->ticket_ = std::max(active_->ticket_, ticket);
+        }
+    }
+
+private:
+    MutationLog* log_;
+    DurableScope* outer_;
+    int uncaught_;
+    bool owner_ = false;
+    std::uint64_t ticket_ = 0;
+
+    static inline thread_local DurableScope* active_ = nullptr;
+};
+
+} // namespace imagined
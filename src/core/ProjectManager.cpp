@@ -1,146 +1,612 @@
 #include "ProjectManager.hpp"
+#include "TalentManager.hpp"
+#include "IdGenerator.hpp"
+#include "Metrics.hpp"
 #include <algorithm>
-#include <random>
-#include <sstream>
-#include <iomanip>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
 
 namespace imagined {
 
-ProjectManager::ProjectManager() {}
+using ReadLock = std::shared_lock<std::shared_mutex>;
+using WriteLock = std::unique_lock<std::shared_mutex>;
+
+ProjectManager::ProjectManager(std::size_t shardCount, std::pmr::memory_resource* resource)
+    : projects_(shardCount, resource) {}
 
 ProjectManager::~ProjectManager() {}
 
 std::string ProjectManager::createProject(const Project& project) {
+    OperationScope timing(OperationId::CREATE_PROJECT);
+    DurableScope scope(log_);
+    Project newProject = project;
+
     // Generate a unique project ID
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-    const char* hex = "0123456789abcdef";
-    std::string uuid;
-    uuid.reserve(36);
-    
-    for (int i = 0; i < 36; i++) {
-        if (i == 8 || i == 13 || i == 18 || i == 23) {
-            uuid += '-';
-        } else {
-            uuid += hex[dis(gen)];
+    while (true) {
+        std::string uuid = generateUuid();
+        auto& shard = projects_.shardFor(uuid);
+        WriteLock lock(shard.mutex);
+        if (shard.findHandle(uuid).valid()) {
+            continue;
+        }
+
+        newProject.id = uuid;
+        ProjectHandle handle = shard.insert(uuid, std::move(newProject));
+        Project& stored = *shard.find(handle);
+        indexProject(shard.index, handle, stored);
+        indexTeam(shard.index, handle, stored);
+        if (talentManager_ != nullptr) {
+            std::vector<std::string> team = stored.assignedTeamMembers;
+            linkTalents(shard.index, handle, stored, team, {});
         }
+        logProject(stored);
+        return uuid;
     }
-    
-    Project newProject = project;
-    newProject.id = uuid;
-    projects_[uuid] = newProject;
-    return uuid;
 }
 
 bool ProjectManager::updateProject(const std::string& projectId, const Project& project) {
-    if (projects_.find(projectId) == projects_.end()) {
+    OperationScope timing(OperationId::UPDATE_PROJECT);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* stored = shard.find(handle);
+    if (stored == nullptr) {
         return false;
     }
-    projects_[projectId] = project;
+    unindexProject(shard.index, handle, *stored);
+    auto previousTeam = shard.index.teams.extract(handle);
+    *stored = project;
+    // The ID is the external key of the handle and cannot be changed by an update
+    stored->id = projectId;
+    indexProject(shard.index, handle, *stored);
+    indexTeam(shard.index, handle, *stored);
+    if (talentManager_ != nullptr) {
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+        auto team = shard.index.teams.find(handle);
+        diffLinks(previousTeam.empty() ? nullptr : &previousTeam.mapped(),
+                  team == shard.index.teams.end() ? nullptr : &team->second, added, removed);
+        linkTalents(shard.index, handle, *stored, added, removed);
+    }
+    logProject(*stored);
     return true;
 }
 
 bool ProjectManager::deleteProject(const std::string& projectId) {
-    return projects_.erase(projectId) > 0;
+    OperationScope timing(OperationId::DELETE_PROJECT);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* stored = shard.find(handle);
+    if (stored == nullptr) {
+        return false;
+    }
+    unindexProject(shard.index, handle, *stored);
+    // Only the project's own members are visited, not every talent
+    std::vector<std::string> team = std::move(stored->assignedTeamMembers);
+    stored->assignedTeamMembers.clear();
+    shard.index.teams.erase(handle);
+    linkTalents(shard.index, handle, *stored, {}, team);
+    shard.erase(projectId);
+    logProjectErased(projectId);
+    return true;
 }
 
 Project ProjectManager::getProject(const std::string& projectId) {
-    if (projects_.find(projectId) == projects_.end()) {
+    OperationScope timing(OperationId::GET_PROJECT);
+    auto& shard = projects_.shardFor(projectId);
+    ReadLock lock(shard.mutex);
+    const Project* project = shard.find(projectId);
+    if (project == nullptr) {
         throw std::runtime_error("Project not found");
     }
-    return projects_[projectId];
+    return *project;
 }
 
-bool ProjectManager::updateProjectStatus(const std::string& projectId, ProjectStatus newStatus) {
-    if (projects_.find(projectId) == projects_.end()) {
+const Project* ProjectManager::findProject(const std::string& projectId) const {
+    OperationScope timing(OperationId::FIND_PROJECT);
+    const auto& shard = projects_.shardFor(projectId);
+    ReadLock lock(shard.mutex);
+    return shard.find(projectId);
+}
+
+bool ProjectManager::withProject(const std::string& projectId,
+                                 const std::function<void(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::WITH_PROJECT);
+    const auto& shard = projects_.shardFor(projectId);
+    ReadLock lock(shard.mutex);
+    const Project* project = shard.find(projectId);
+    if (project == nullptr) {
         return false;
     }
-    projects_[projectId].status = newStatus;
+    visitor(*project);
     return true;
 }
 
-std::vector<Project> ProjectManager::getProjectsByStatus(ProjectStatus status) {
-    std::vector<Project> result;
-    for (const auto& pair : projects_) {
-        if (pair.second.status == status) {
-            result.push_back(pair.second);
+bool ProjectManager::containsProject(const std::string& projectId) const {
+    OperationScope timing(OperationId::CONTAINS_PROJECT);
+    const auto& shard = projects_.shardFor(projectId);
+    ReadLock lock(shard.mutex);
+    return shard.findHandle(projectId).valid();
+}
+
+std::size_t ProjectManager::projectCount() const {
+    OperationScope timing(OperationId::PROJECT_COUNT);
+    return projects_.size();
+}
+
+ProjectHandle ProjectManager::findProjectHandle(const std::string& projectId) const {
+    OperationScope timing(OperationId::FIND_PROJECT_HANDLE);
+    const auto& shard = projects_.shardFor(projectId);
+    ReadLock lock(shard.mutex);
+    return shard.findHandle(projectId);
+}
+
+const Project* ProjectManager::findProject(ProjectHandle handle) const {
+    OperationScope timing(OperationId::FIND_PROJECT);
+    const auto& shard = projects_.shardOf(handle);
+    ReadLock lock(shard.mutex);
+    return shard.find(handle);
+}
+
+void ProjectManager::attachLog(MutationLog* log) {
+    log_ = log;
+}
+
+void ProjectManager::attachChangeFeed(ChangeFeed* feed) {
+    feed_ = feed;
+}
+
+void ProjectManager::attachTalentManager(TalentManager* talents) {
+    if (talentManager_ != nullptr) {
+        talentManager_->projectManager_ = nullptr;
+    }
+    talentManager_ = talents;
+    if (talents != nullptr) {
+        talents->projectManager_ = this;
+    }
+}
+
+bool ProjectManager::restoreProject(const Project& project) {
+    OperationScope timing(OperationId::RESTORE_PROJECT);
+    if (project.id.empty()) {
+        return false;
+    }
+    auto& shard = projects_.shardFor(project.id);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(project.id);
+    if (Project* stored = shard.find(handle)) {
+        unindexProject(shard.index, handle, *stored);
+        *stored = project;
+    } else {
+        handle = shard.insert(project.id, project);
+    }
+    indexProject(shard.index, handle, *shard.find(handle));
+    indexTeam(shard.index, handle, *shard.find(handle));
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::PROJECT, ChangeType::PUT, project.id);
+    }
+    return true;
+}
+
+void ProjectManager::forEachProject(const std::function<bool(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_PROJECT);
+    for (std::size_t i = 0; i < projects_.shardCount(); ++i) {
+        const auto& shard = projects_.shard(i);
+        ReadLock lock(shard.mutex);
+        bool keepGoing = true;
+        shard.forEach([&](ProjectHandle, const Project& project) {
+            keepGoing = visitor(project);
+            return keepGoing;
+        });
+        if (!keepGoing) {
+            return;
         }
     }
+}
+
+bool ProjectManager::updateProjectStatus(const std::string& projectId, ProjectStatus newStatus) {
+    OperationScope timing(OperationId::UPDATE_PROJECT_STATUS);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr) {
+        return false;
+    }
+    unindexProject(shard.index, handle, *project);
+    project->status = newStatus;
+    indexProject(shard.index, handle, *project);
+    logProject(*project);
+    return true;
+}
+
+std::vector<Project> ProjectManager::getProjectsByStatus(ProjectStatus status) {
+    OperationScope timing(OperationId::GET_PROJECTS_BY_STATUS);
+    std::vector<Project> result = collectProjects([status](const ShardIndex& index) {
+        return &index.byStatus[static_cast<std::size_t>(status)];
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
+void ProjectManager::forEachProjectWithStatus(ProjectStatus status,
+                                              const std::function<bool(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_PROJECT_WITH_STATUS);
+    visitProjects([status](const ShardIndex& index) {
+        return &index.byStatus[static_cast<std::size_t>(status)];
+    }, visitor);
+}
+
 bool ProjectManager::assignTeamMember(const std::string& projectId, const std::string& teamMemberId) {
-    if (projects_.find(projectId) == projects_.end()) {
+    OperationScope timing(OperationId::ASSIGN_TEAM_MEMBER);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr || !addTeamMember(shard.index, handle, *project, teamMemberId) ||
+        linkTalents(shard.index, handle, *project, {teamMemberId}, {}) > 0) {
         return false;
     }
-    auto& project = projects_[projectId];
-    if (std::find(project.assignedTeamMembers.begin(), 
-                  project.assignedTeamMembers.end(), 
-                  teamMemberId) == project.assignedTeamMembers.end()) {
-        project.assignedTeamMembers.push_back(teamMemberId);
-        return true;
-    }
-    return false;
+    logProject(*project);
+    return true;
 }
 
 bool ProjectManager::removeTeamMember(const std::string& projectId, const std::string& teamMemberId) {
-    if (projects_.find(projectId) == projects_.end()) {
+    OperationScope timing(OperationId::REMOVE_TEAM_MEMBER);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr || !dropTeamMember(shard.index, handle, *project, teamMemberId)) {
         return false;
     }
-    auto& project = projects_[projectId];
-    auto it = std::find(project.assignedTeamMembers.begin(), 
-                       project.assignedTeamMembers.end(), 
-                       teamMemberId);
-    if (it != project.assignedTeamMembers.end()) {
-        project.assignedTeamMembers.erase(it);
-        return true;
+    linkTalents(shard.index, handle, *project, {}, {teamMemberId});
+    logProject(*project);
+    return true;
+}
+
+std::size_t ProjectManager::assignTeamMembers(const std::string& projectId,
+                                              const std::vector<std::string>& teamMemberIds) {
+    OperationScope timing(OperationId::ASSIGN_TEAM_MEMBERS);
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr) {
+        return 0;
+    }
+    std::vector<std::string> added;
+    for (const auto& teamMemberId : teamMemberIds) {
+        if (addTeamMember(shard.index, handle, *project, teamMemberId)) {
+            added.push_back(teamMemberId);
+        }
     }
-    return false;
+    std::size_t assigned = added.size() - linkTalents(shard.index, handle, *project, added, {});
+    // One record for the whole batch
+    if (assigned > 0) {
+        logProject(*project);
+    }
+    timing.setResultSize(assigned);
+    return assigned;
 }
 
 std::vector<Project> ProjectManager::getProjectsByClient(const std::string& clientId) {
-    std::vector<Project> result;
-    for (const auto& pair : projects_) {
-        if (pair.second.clientId == clientId) {
-            result.push_back(pair.second);
-        }
+    OperationScope timing(OperationId::GET_PROJECTS_BY_CLIENT);
+    // A client ID that was never interned has no projects
+    std::optional<Symbol> client = Symbol::find(clientId);
+    if (!client) {
+        return {};
     }
+    std::vector<Project> result = collectProjects([client = *client](const ShardIndex& index) -> const ProjectSet* {
+        auto it = index.byClient.find(client);
+        return it == index.byClient.end() ? nullptr : &it->second;
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
 std::vector<Project> ProjectManager::getProjectsByType(ProjectType type) {
-    std::vector<Project> result;
-    for (const auto& pair : projects_) {
-        if (pair.second.type == type) {
-            result.push_back(pair.second);
-        }
-    }
+    OperationScope timing(OperationId::GET_PROJECTS_BY_TYPE);
+    std::vector<Project> result = collectProjects([type](const ShardIndex& index) {
+        return &index.byType[static_cast<std::size_t>(type)];
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
+void ProjectManager::forEachProjectOfClient(const std::string& clientId,
+                                            const std::function<bool(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_PROJECT_OF_CLIENT);
+    std::optional<Symbol> client = Symbol::find(clientId);
+    if (!client) {
+        return;
+    }
+    visitProjects([client = *client](const ShardIndex& index) -> const ProjectSet* {
+        auto it = index.byClient.find(client);
+        return it == index.byClient.end() ? nullptr : &it->second;
+    }, visitor);
+}
+
+void ProjectManager::forEachProjectOfType(ProjectType type,
+                                          const std::function<bool(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_PROJECT_OF_TYPE);
+    visitProjects([type](const ShardIndex& index) {
+        return &index.byType[static_cast<std::size_t>(type)];
+    }, visitor);
+}
+
 std::vector<Project> ProjectManager::getUpcomingDeadlines(int daysThreshold) {
+    OperationScope timing(OperationId::GET_UPCOMING_DEADLINES);
     std::vector<Project> result;
+    scanUpcomingDeadlines(daysThreshold, std::nullopt, [&](ProjectHandle, const Project& project) {
+        result.push_back(project);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+DeadlinePage ProjectManager::getUpcomingDeadlinesPage(int daysThreshold, std::size_t pageSize,
+                                                      const std::optional<DeadlineCursor>& after) {
+    OperationScope timing(OperationId::GET_UPCOMING_DEADLINES_PAGE);
+    DeadlinePage page;
+    if (pageSize == 0) {
+        return page;
+    }
+
+    DeadlineCursor last;
+    bool more = false;
+    scanUpcomingDeadlines(daysThreshold, after, [&](ProjectHandle handle, const Project& project) {
+        if (page.projects.size() == pageSize) {
+            more = true;
+            return false;
+        }
+        page.projects.push_back(project);
+        last = DeadlineCursor{project.deadline, handle};
+        return true;
+    });
+
+    if (more) {
+        page.nextCursor = last;
+    }
+    timing.setResultSize(page.projects.size());
+    return page;
+}
+
+void ProjectManager::forEachUpcomingDeadline(int daysThreshold,
+                                             const std::function<bool(const Project&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_UPCOMING_DEADLINE);
+    scanUpcomingDeadlines(daysThreshold, std::nullopt, [&](ProjectHandle, const Project& project) {
+        return visitor(project);
+    });
+}
+
+template <typename Visitor>
+void ProjectManager::scanUpcomingDeadlines(int daysThreshold, const std::optional<DeadlineCursor>& after,
+                                           Visitor&& visitor) const {
     auto now = std::chrono::system_clock::now();
-    auto threshold = std::chrono::hours(24 * daysThreshold);
-    
-    for (const auto& pair : projects_) {
-        if (pair.second.status != ProjectStatus::COMPLETED && 
-            pair.second.status != ProjectStatus::CANCELLED) {
-            auto timeUntilDeadline = pair.second.deadline - now;
-            if (timeUntilDeadline <= threshold && timeUntilDeadline > std::chrono::hours(0)) {
-                result.push_back(pair.second);
-            }
+    auto limit = now + std::chrono::hours(24 * daysThreshold);
+
+    using Iterator = decltype(ShardIndex::activeDeadlines)::const_iterator;
+    struct Head {
+        Iterator it;
+        Iterator end;
+        const Store::Shard* shard;
+    };
+    auto later = [](const Head& a, const Head& b) { return DeadlineOrder()(*b.it, *a.it); };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+
+    // Each shard's index is already sorted, so a k-way merge over the shards
+    // yields the global deadline order. All shards stay read-locked meanwhile.
+    auto locks = projects_.lockAllShared();
+    for (std::size_t i = 0; i < projects_.shardCount(); ++i) {
+        const auto& shard = projects_.shard(i);
+        const auto& deadlines = shard.index.activeDeadlines;
+
+        // Due strictly after now and no later than the threshold
+        Iterator it = (after && after->deadline > now)
+                          ? deadlines.upper_bound(DeadlineEntry{after->deadline, after->project})
+                          : deadlines.upper_bound(now);
+        if (it != deadlines.end() && it->deadline <= limit) {
+            heads.push(Head{it, deadlines.end(), &shard});
         }
     }
-    
-    // Sort by deadline
-    std::sort(result.begin(), result.end(), 
-              [](const Project& a, const Project& b) {
-                  return a.deadline < b.deadline;
-              });
-    
+
+    while (!heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        if (!visitor(head.it->project, *head.shard->find(head.it->project))) {
+            break;
+        }
+        if (++head.it != head.end && head.it->deadline <= limit) {
+            heads.push(head);
+        }
+    }
+}
+
+void ProjectManager::logProject(const Project& project) {
+    if (log_ != nullptr) {
+        DurableScope::note(log_->putProject(project));
+    }
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::PROJECT, ChangeType::PUT, project.id);
+    }
+}
+
+void ProjectManager::logProjectErased(const std::string& projectId) {
+    if (log_ != nullptr) {
+        DurableScope::note(log_->eraseProject(projectId));
+    }
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::PROJECT, ChangeType::ERASE, projectId);
+    }
+}
+
+bool ProjectManager::isActive(const Project& project) {
+    return project.status != ProjectStatus::COMPLETED &&
+           project.status != ProjectStatus::CANCELLED;
+}
+
+void ProjectManager::indexProject(ShardIndex& index, ProjectHandle handle, const Project& project) {
+    if (isActive(project)) {
+        index.activeDeadlines.insert(DeadlineEntry{project.deadline, handle});
+    }
+    index.byStatus[static_cast<std::size_t>(project.status)].insert(handle);
+    index.byType[static_cast<std::size_t>(project.type)].insert(handle);
+    index.byClient[project.clientId].insert(handle);
+}
+
+void ProjectManager::unindexProject(ShardIndex& index, ProjectHandle handle, const Project& project) {
+    if (isActive(project)) {
+        index.activeDeadlines.erase(DeadlineEntry{project.deadline, handle});
+    }
+    index.byStatus[static_cast<std::size_t>(project.status)].erase(handle);
+    index.byType[static_cast<std::size_t>(project.type)].erase(handle);
+
+    auto clientIt = index.byClient.find(project.clientId);
+    if (clientIt != index.byClient.end()) {
+        clientIt->second.erase(handle);
+        if (clientIt->second.empty()) {
+            index.byClient.erase(clientIt);
+        }
+    }
+}
+
+void ProjectManager::indexTeam(ShardIndex& index, ProjectHandle handle, Project& project) {
+    index.teams.erase(handle);
+    if (project.assignedTeamMembers.empty()) {
+        return;
+    }
+    indexLinks(index.teams[handle], project.assignedTeamMembers);
+}
+
+bool ProjectManager::addTeamMember(ShardIndex& index, ProjectHandle handle, Project& project,
+                                   const std::string& teamMemberId) {
+    return addLink(index.teams[handle], project.assignedTeamMembers, teamMemberId);
+}
+
+bool ProjectManager::dropTeamMember(ShardIndex& index, ProjectHandle handle, Project& project,
+                                    const std::string& teamMemberId) {
+    auto team = index.teams.find(handle);
+    if (team == index.teams.end() || !removeLink(team->second, project.assignedTeamMembers, teamMemberId)) {
+        return false;
+    }
+    if (team->second.empty()) {
+        index.teams.erase(team);
+    }
+    return true;
+}
+
+std::size_t ProjectManager::linkTalents(ShardIndex& index, ProjectHandle handle, Project& project,
+                                        const std::vector<std::string>& added,
+                                        const std::vector<std::string>& removed) {
+    if (talentManager_ == nullptr) {
+        return 0;
+    }
+    for (const auto& talentId : removed) {
+        talentManager_->linkProjectSide(talentId, project.id, false);
+    }
+    std::size_t missing = 0;
+    for (const auto& talentId : added) {
+        if (!talentManager_->linkProjectSide(talentId, project.id, true)) {
+            dropTeamMember(index, handle, project, talentId);
+            ++missing;
+        }
+    }
+    return missing;
+}
+
+bool ProjectManager::linkPair(const std::string& projectId, const std::string& talentId, bool linked) {
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr && linked) {
+        return false;
+    }
+    bool changed = false;
+    bool talentExists = talentManager_->linkProjectSide(talentId, projectId, linked, &changed);
+    if (project != nullptr && (talentExists || !linked) &&
+        (linked ? addTeamMember(shard.index, handle, *project, talentId)
+                : dropTeamMember(shard.index, handle, *project, talentId))) {
+        logProject(*project);
+    }
+    return changed;
+}
+
+void ProjectManager::reconcileLink(const std::string& projectId, const std::string& talentId) {
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    bool held = talentManager_->holdsProject(talentId, projectId);
+    if (project == nullptr) {
+        if (held) {
+            talentManager_->linkProjectSide(talentId, projectId, false);
+        }
+        return;
+    }
+    if (held ? addTeamMember(shard.index, handle, *project, talentId)
+             : dropTeamMember(shard.index, handle, *project, talentId)) {
+        logProject(*project);
+    }
+}
+
+bool ProjectManager::commitTeam(const std::string& projectId, const std::vector<std::string>& talentIds,
+                                const std::function<bool()>& commitTalents) {
+    DurableScope scope(log_);
+    auto& shard = projects_.shardFor(projectId);
+    WriteLock lock(shard.mutex);
+    ProjectHandle handle = shard.findHandle(projectId);
+    Project* project = shard.find(handle);
+    if (project == nullptr || !commitTalents()) {
+        return false;
+    }
+    bool changed = false;
+    for (const auto& talentId : talentIds) {
+        changed |= addTeamMember(shard.index, handle, *project, talentId);
+    }
+    if (changed) {
+        logProject(*project);
+    }
+    return true;
+}
+
+std::vector<Project> ProjectManager::collectProjects(
+    const std::function<const ProjectSet*(const ShardIndex&)>& select) const {
+    std::vector<Project> result;
+    visitProjects(select, [&](const Project& project) {
+        result.push_back(project);
+        return true;
+    });
     return result;
 }
 
+void ProjectManager::visitProjects(const std::function<const ProjectSet*(const ShardIndex&)>& select,
+                                   const std::function<bool(const Project&)>& visitor) const {
+    for (std::size_t i = 0; i < projects_.shardCount(); ++i) {
+        const auto& shard = projects_.shard(i);
+        ReadLock lock(shard.mutex);
+        const ProjectSet* projects = select(shard.index);
+        if (projects == nullptr) {
+            continue;
+        }
+        for (ProjectHandle handle : *projects) {
+            if (!visitor(*shard.find(handle))) {
+                return;
+            }
+        }
+    }
+}
+
 } // namespace imagined 
\ No newline at end of file
@@ -1,13 +1,30 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
+#include "EnumNames.hpp"
+#include "Handle.hpp"
+#include "ChangeFeed.hpp"
+#include "LinkPositions.hpp"
+#include "MutationLog.hpp"
+#include "ShardedStore.hpp"
+#include "Symbol.hpp"
 
 namespace imagined {
 
+class TalentManager;
+
 enum class ProjectStatus {
     PENDING,
     IN_PROGRESS,
@@ -16,6 +33,8 @@ enum class ProjectStatus {
     CANCELLED
 };
 
+constexpr std::size_t kProjectStatusCount = 5;
+
 enum class ProjectType {
     THREE_D_DESIGN,
     APP_DESIGN,
@@ -29,10 +48,28 @@ enum class ProjectType {
     PACKAGING_DESIGN
 };
 
+constexpr std::size_t kProjectTypeCount = 10;
+
+constexpr std::array<std::string_view, kProjectTypeCount> kProjectTypeNames = {
+    "THREE_D_DESIGN", "APP_DESIGN", "WEB_DESIGN", "MOTION_DESIGN", "BRAND_IDENTITY",
+    "VIDEO_PRODUCTION", "TWO_D_ANIMATION", "PITCH_DECK", "AD_GRAPHICS", "PACKAGING_DESIGN"
+};
+
+constexpr std::string_view projectTypeName(ProjectType type) {
+    return enumName(type, kProjectTypeNames);
+}
+
+// Accepts the enumerator name or its number, e.g. "WEB_DESIGN" or "2"
+constexpr std::optional<ProjectType> parseProjectType(std::string_view text) {
+    return parseEnumName<ProjectType>(text, kProjectTypeNames);
+}
+
+static_assert(parseProjectType("PACKAGING_DESIGN") == ProjectType::PACKAGING_DESIGN, "project type names out of order");
+
 struct Project {
     std::string id;
     std::string name;
-    std::string clientId;
+    Symbol clientId;
     ProjectType type;
     ProjectStatus status;
     std::chrono::system_clock::time_point deadline;
@@ -42,9 +79,41 @@ struct Project {
     std::string description;
 };
 
+// Position in the deadline-ordered stream; resume strictly after it.
+struct DeadlineCursor {
+    std::chrono::system_clock::time_point deadline;
+    ProjectHandle project;
+};
+
+struct DeadlinePage {
+    std::vector<Project> projects;
+    std::optional<DeadlineCursor> nextCursor;  // Empty once the window is exhausted
+};
+
+// Projects are stored in a sharded slot map and addressed internally by
+// ProjectHandle; the UUID string is only mapped to a handle at the public
+// API boundary.
+//
+// Thread safety: every method may be called concurrently. Projects are
+// sharded by ID hash and each shard has its own reader-writer lock, so calls
+// touching different projects proceed in parallel. Secondary indexes live
+// inside the shards and queries merge them shard by shard.
+//
+// Read views: forEach* and with* run the visitor while holding the shard's
+// read lock, so the visitor must not call back into mutating methods of the
+// same manager. find* returns a raw pointer (nullptr when missing) that stays
+// valid only until the next mutating call; it is not protected against
+// concurrent writers and is meant for single-threaded use.
 class ProjectManager {
 public:
-    ProjectManager();
+    // Slots, the ID map and the secondary indexes allocate from `resource`,
+    // which must outlive the manager and be thread-safe when the manager is
+    // shared between threads, e.g. std::pmr::synchronized_pool_resource. A
+    // monotonic_buffer_resource suits a single-threaded bulk load that is
+    // rarely deleted from, as it never reuses freed memory. The strings and
+    // vectors inside each Project still use the global heap.
+    explicit ProjectManager(std::size_t shardCount = 1,
+                            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~ProjectManager();
 
     // Project CRUD operations
@@ -52,23 +121,146 @@ public:
     bool updateProject(const std::string& projectId, const Project& project);
     bool deleteProject(const std::string& projectId);
     Project getProject(const std::string& projectId);
+    const Project* findProject(const std::string& projectId) const;
+    bool withProject(const std::string& projectId,
+                     const std::function<void(const Project&)>& visitor) const;
+    bool containsProject(const std::string& projectId) const;
+    std::size_t projectCount() const;
+
+    // Handle-based access
+    ProjectHandle findProjectHandle(const std::string& projectId) const;
+    const Project* findProject(ProjectHandle handle) const;
+
+    // Persistence. Once a log is attached every mutation is recorded in it
+    // and returns only after its record is durable, or throws
+    // std::runtime_error if the log failed; attach before concurrent use.
+    // restoreProject inserts or replaces a project under its own ID and is
+    // meant for recovery, before a log is attached.
+    void attachLog(MutationLog* log);
+    // Every mutation, restores included, publishes a PROJECT event to the
+    // attached feed; attach before concurrent use
+    void attachChangeFeed(ChangeFeed* feed);
+    // Opts in to linking each project's team to the talents'
+    // completedProjects, on both managers; see Team management. Nothing is
+    // linked unless this is called. Attach once, before any team or project
+    // is recorded and before concurrent use; earlier links are not reconciled.
+    void attachTalentManager(TalentManager* talents);
+    bool restoreProject(const Project& project);
+    void forEachProject(const std::function<bool(const Project&)>& visitor) const;
     
     // Project status management
     bool updateProjectStatus(const std::string& projectId, ProjectStatus newStatus);
     std::vector<Project> getProjectsByStatus(ProjectStatus status);
+    void forEachProjectWithStatus(ProjectStatus status,
+                                  const std::function<bool(const Project&)>& visitor) const;
     
-    // Team management
+    // Team management. Each member's position in assignedTeamMembers is
+    // indexed, so checking, adding or removing one is O(1); a removal moves
+    // the last member into its place, and repeated IDs are dropped on create
+    // and update. assignTeamMembers adds every ID not on the team yet and
+    // returns how many it added.
+    //
+    // Only with a TalentManager attached is every change to a team, deleting
+    // the project included, applied to the talents' completedProjects, under
+    // the project's lock, which is always taken before a talent's. A member
+    // whose talent does not exist is then not added.
     bool assignTeamMember(const std::string& projectId, const std::string& teamMemberId);
     bool removeTeamMember(const std::string& projectId, const std::string& teamMemberId);
+    std::size_t assignTeamMembers(const std::string& projectId, const std::vector<std::string>& teamMemberIds);
     
     // Project tracking
     std::vector<Project> getProjectsByClient(const std::string& clientId);
     std::vector<Project> getProjectsByType(ProjectType type);
+    void forEachProjectOfClient(const std::string& clientId,
+                                const std::function<bool(const Project&)>& visitor) const;
+    void forEachProjectOfType(ProjectType type,
+                              const std::function<bool(const Project&)>& visitor) const;
     std::vector<Project> getUpcomingDeadlines(int daysThreshold);
+    DeadlinePage getUpcomingDeadlinesPage(int daysThreshold, std::size_t pageSize,
+                                          const std::optional<DeadlineCursor>& after = std::nullopt);
+    // Visits active projects due within the window in deadline order until the visitor returns false
+    void forEachUpcomingDeadline(int daysThreshold,
+                                 const std::function<bool(const Project&)>& visitor) const;
 
 private:
-    std::unordered_map<std::string, Project> projects_;
-    // Add more private members as needed
+    using ProjectSet = std::pmr::unordered_set<ProjectHandle, HandleHash>;
+
+    // Active (not COMPLETED/CANCELLED) projects ordered by deadline, then handle
+    struct DeadlineEntry {
+        std::chrono::system_clock::time_point deadline;
+        ProjectHandle project;
+    };
+    struct DeadlineOrder {
+        using is_transparent = void;
+        bool operator()(const DeadlineEntry& a, const DeadlineEntry& b) const {
+            return a.deadline < b.deadline || (a.deadline == b.deadline && a.project < b.project);
+        }
+        bool operator()(const DeadlineEntry& a, std::chrono::system_clock::time_point b) const {
+            return a.deadline < b;
+        }
+        bool operator()(std::chrono::system_clock::time_point a, const DeadlineEntry& b) const {
+            return a < b.deadline;
+        }
+    };
+
+    // Secondary indexes of the projects stored in one shard
+    struct ShardIndex {
+        explicit ShardIndex(std::pmr::memory_resource* resource)
+            : byStatus(makeContainerArray<ProjectSet, kProjectStatusCount>(resource)),
+              byType(makeContainerArray<ProjectSet, kProjectTypeCount>(resource)),
+              byClient(resource),
+              activeDeadlines(resource),
+              teams(resource) {}
+
+        std::array<ProjectSet, kProjectStatusCount> byStatus;
+        std::array<ProjectSet, kProjectTypeCount> byType;
+        std::pmr::unordered_map<Symbol, ProjectSet, SymbolHash> byClient;
+        std::pmr::set<DeadlineEntry, DeadlineOrder> activeDeadlines;
+        // assignedTeamMembers of each project that has any
+        std::pmr::unordered_map<ProjectHandle, LinkPositions, HandleHash> teams;
+    };
+
+    using Store = ShardedStore<Project, ProjectTag, ShardIndex>;
+    Store projects_;
+    MutationLog* log_ = nullptr;
+    ChangeFeed* feed_ = nullptr;
+    TalentManager* talentManager_ = nullptr;
+
+    friend class TalentManager;
+
+    static bool isActive(const Project& project);
+    void logProject(const Project& project);
+    void logProjectErased(const std::string& projectId);
+    template <typename Visitor>
+    void scanUpcomingDeadlines(int daysThreshold, const std::optional<DeadlineCursor>& after,
+                               Visitor&& visitor) const;
+
+    static void indexProject(ShardIndex& index, ProjectHandle handle, const Project& project);
+    static void unindexProject(ShardIndex& index, ProjectHandle handle, const Project& project);
+    static void indexTeam(ShardIndex& index, ProjectHandle handle, Project& project);
+    static bool addTeamMember(ShardIndex& index, ProjectHandle handle, Project& project,
+                              const std::string& teamMemberId);
+    static bool dropTeamMember(ShardIndex& index, ProjectHandle handle, Project& project,
+                               const std::string& teamMemberId);
+    // Applies a team change to the talents, taking each talent's shard lock
+    // inside the project's; returns how many added members were taken off
+    // the team again because their talent does not exist
+    std::size_t linkTalents(ShardIndex& index, ProjectHandle handle, Project& project,
+                            const std::vector<std::string>& added, const std::vector<std::string>& removed);
+
+    // Entry points of the linked TalentManager, which never holds a talent
+    // lock when calling them. linkPair links or unlinks both sides and
+    // returns whether the talent's side changed; reconcileLink makes the
+    // team agree with the talent's completedProjects; commitTeam runs
+    // commitTalents under the project's lock and, if it succeeds, adds
+    // talentIds to the team.
+    bool linkPair(const std::string& projectId, const std::string& talentId, bool linked);
+    void reconcileLink(const std::string& projectId, const std::string& talentId);
+    bool commitTeam(const std::string& projectId, const std::vector<std::string>& talentIds,
+                    const std::function<bool()>& commitTalents);
+    std::vector<Project> collectProjects(const std::function<const ProjectSet*(const ShardIndex&)>& select) const;
+    void visitProjects(const std::function<const ProjectSet*(const ShardIndex&)>& select,
+                       const std::function<bool(const Project&)>& visitor) const;
 };
 
 } // namespace imagined 
\ No newline at end of file
@@ -1,255 +1,1278 @@
 #include "ResourceAllocator.hpp"
+#include "AssignmentSolver.hpp"
+#include "IdGenerator.hpp"
+#include "Metrics.hpp"
 #include <algorithm>
-#include <random>
-#include <sstream>
-#include <iomanip>
 #include <cmath>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
 
 namespace imagined {
 
-ResourceAllocator::ResourceAllocator(ProjectManager& projectManager, TalentManager& talentManager)
-    : projectManager_(projectManager), talentManager_(talentManager) {}
+namespace {
 
-ResourceAllocator::~ResourceAllocator() {}
+// Optimistic allocation gives up after this many conflicting commits
+constexpr int kMaxAllocationAttempts = 8;
+
+// Utilization bands used by the reports and the rebalancer, over a window of
+// this many days starting today
+constexpr double kUnderutilizedThreshold = 0.3;
+constexpr double kOverutilizedThreshold = 0.9;
+constexpr UtilizationHistory::Bucket kUtilizationWindowDays = 7;
+constexpr auto kUtilizationWindow = UtilizationHistory::kBucketWidth * kUtilizationWindowDays;
+
+// A batch is re-solved without its failed requests at most this many times
+constexpr int kMaxBatchSolveRounds = 4;
+
+// Cost-ranking positions a batch request may reach beyond its own slot
+constexpr std::size_t kBatchCandidateSlack = 8;
+
+// Talents are ranked by hourly cost: at the same rate, each experience level
+// above junior makes a talent 5% cheaper, and for a single allocation each
+// project already recorded on the talent makes it 10% dearer
+constexpr std::array<double, kExperienceLevelCount> kLevelCostFactors = {1.0, 0.95, 0.90, 0.85};
+constexpr double kLoadCostFactor = 0.1;
+
+double windowHours(const AllocationPlan& plan) {
+    return std::chrono::duration<double, std::ratio<3600>>(plan.endDate - plan.startDate).count();
+}
+
+struct PooledTalent {
+    TalentCandidate candidate;
+    double hourlyRate;
+    double rankedCost;
+    std::size_t node;  // Talent index in the assignment problem
+};
+
+} // namespace
+
+using ReadLock = std::shared_lock<std::shared_mutex>;
+using WriteLock = std::unique_lock<std::shared_mutex>;
+
+ResourceAllocator::ResourceAllocator(ProjectManager& projectManager, TalentManager& talentManager,
+                                     std::size_t shardCount, std::pmr::memory_resource* resource)
+    : projectManager_(projectManager), talentManager_(talentManager), resources_(shardCount, resource),
+      projectResources_(std::max<std::size_t>(16, resources_.shardCount()), resource) {}
+
+ResourceAllocator::~ResourceAllocator() {
+    stopBackgroundOptimizer();
+}
 
 std::string ResourceAllocator::addResource(const Resource& resource) {
+    OperationScope timing(OperationId::ADD_RESOURCE);
+    DurableScope scope(log_);
+    Resource newResource = resource;
+
     // Generate a unique resource ID
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-    const char* hex = "0123456789abcdef";
-    std::string uuid;
-    uuid.reserve(36);
-    
-    for (int i = 0; i < 36; i++) {
-        if (i == 8 || i == 13 || i == 18 || i == 23) {
-            uuid += '-';
-        } else {
-            uuid += hex[dis(gen)];
+    while (true) {
+        std::string uuid = generateUuid();
+        auto& shard = resources_.shardFor(uuid);
+        WriteLock lock(shard.mutex);
+        if (shard.findHandle(uuid).valid()) {
+            continue;
         }
+
+        newResource.id = uuid;
+        ResourceHandle handle = shard.insert(uuid, makeEntry(newResource));
+        shard.index.byType[resource.type].insert(handle);
+        shard.index.byBand[static_cast<std::size_t>(UtilizationBand::UNDER)].insert(handle);
+        linkProjects(handle, *shard.find(handle));
+        markResourceChanged(handle);
+        logResource(*shard.find(handle));
+        return uuid;
     }
-    
-    Resource newResource = resource;
-    newResource.id = uuid;
-    resources_[uuid] = newResource;
-    return uuid;
 }
 
 bool ResourceAllocator::updateResource(const std::string& resourceId, const Resource& resource) {
-    if (resources_.find(resourceId) == resources_.end()) {
+    OperationScope timing(OperationId::UPDATE_RESOURCE);
+    DurableScope scope(log_);
+    auto& shard = resources_.shardFor(resourceId);
+    WriteLock lock(shard.mutex);
+    ResourceHandle handle = shard.findHandle(resourceId);
+    ResourceEntry* entry = shard.find(handle);
+    if (entry == nullptr) {
         return false;
     }
-    resources_[resourceId] = resource;
+    if (entry->resource.type != resource.type) {
+        unindexResourceType(shard.index, handle, entry->resource.type);
+        shard.index.byType[resource.type].insert(handle);
+    }
+    std::string previousProjectId = std::move(entry->resource.currentProjectId);
+    entry->resource = resource;
+    // The ID is the external key of the handle and cannot be changed by an update
+    entry->resource.id = resourceId;
+    if (previousProjectId != entry->resource.currentProjectId) {
+        syncProjectLink(handle, *entry, previousProjectId);
+        syncProjectLink(handle, *entry, entry->resource.currentProjectId);
+    }
+    ++entry->version;
+    markResourceChanged(handle);
+    logResource(*entry);
     return true;
 }
 
 bool ResourceAllocator::removeResource(const std::string& resourceId) {
-    return resources_.erase(resourceId) > 0;
+    OperationScope timing(OperationId::REMOVE_RESOURCE);
+    DurableScope scope(log_);
+    auto& shard = resources_.shardFor(resourceId);
+    WriteLock lock(shard.mutex);
+    ResourceHandle handle = shard.findHandle(resourceId);
+    const ResourceEntry* entry = shard.find(handle);
+    if (entry == nullptr) {
+        return false;
+    }
+    unindexResourceType(shard.index, handle, entry->resource.type);
+    shard.index.byBand[static_cast<std::size_t>(entry->band)].erase(handle);
+    unlinkProjects(handle, *entry);
+    shard.erase(resourceId);
+    if (log_ != nullptr) {
+        DurableScope::note(log_->eraseResource(resourceId));
+    }
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::RESOURCE, ChangeType::ERASE, resourceId);
+    }
+    return true;
 }
 
 Resource ResourceAllocator::getResource(const std::string& resourceId) {
-    if (resources_.find(resourceId) == resources_.end()) {
+    OperationScope timing(OperationId::GET_RESOURCE);
+    auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    if (entry == nullptr) {
         throw std::runtime_error("Resource not found");
     }
-    return resources_[resourceId];
+    return entry->resource;
+}
+
+const Resource* ResourceAllocator::findResource(const std::string& resourceId) const {
+    OperationScope timing(OperationId::FIND_RESOURCE);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    return entry == nullptr ? nullptr : &entry->resource;
+}
+
+bool ResourceAllocator::withResource(const std::string& resourceId,
+                                     const std::function<void(const Resource&)>& visitor) const {
+    OperationScope timing(OperationId::WITH_RESOURCE);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    if (entry == nullptr) {
+        return false;
+    }
+    visitor(entry->resource);
+    return true;
+}
+
+std::size_t ResourceAllocator::resourceCount() const {
+    OperationScope timing(OperationId::RESOURCE_COUNT);
+    return resources_.size();
+}
+
+ResourceHandle ResourceAllocator::findResourceHandle(const std::string& resourceId) const {
+    OperationScope timing(OperationId::FIND_RESOURCE_HANDLE);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    return shard.findHandle(resourceId);
+}
+
+const Resource* ResourceAllocator::findResource(ResourceHandle handle) const {
+    OperationScope timing(OperationId::FIND_RESOURCE);
+    const auto& shard = resources_.shardOf(handle);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(handle);
+    return entry == nullptr ? nullptr : &entry->resource;
+}
+
+void ResourceAllocator::attachLog(MutationLog* log) {
+    log_ = log;
+}
+
+void ResourceAllocator::attachChangeFeed(ChangeFeed* feed) {
+    feed_ = feed;
+}
+
+bool ResourceAllocator::restoreResource(const Resource& resource, const std::vector<Booking>& bookings) {
+    OperationScope timing(OperationId::RESTORE_RESOURCE);
+    if (resource.id.empty()) {
+        return false;
+    }
+    auto& shard = resources_.shardFor(resource.id);
+    WriteLock lock(shard.mutex);
+    ResourceHandle handle = shard.findHandle(resource.id);
+    if (ResourceEntry* entry = shard.find(handle)) {
+        unindexResourceType(shard.index, handle, entry->resource.type);
+        shard.index.byBand[static_cast<std::size_t>(entry->band)].erase(handle);
+        unlinkProjects(handle, *entry);
+        shard.erase(resource.id);
+    }
+    handle = shard.insert(resource.id, makeEntry(resource));
+    ResourceEntry& entry = *shard.find(handle);
+    for (const auto& booking : bookings) {
+        if (entry.calendar.book(booking.startDate, booking.endDate, booking.projectId)) {
+            entry.history.add(booking.startDate, booking.endDate);
+        }
+    }
+    shard.index.byType[resource.type].insert(handle);
+    shard.index.byBand[static_cast<std::size_t>(UtilizationBand::UNDER)].insert(handle);
+    updateUtilization(shard, handle, entry);
+    linkProjects(handle, entry);
+    markResourceChanged(handle);
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::RESOURCE, ChangeType::PUT, resource.id);
+    }
+    return true;
+}
+
+void ResourceAllocator::forEachResource(
+    const std::function<bool(const Resource&, const BookingCalendar&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_RESOURCE);
+    forEachEntry([&](const ResourceEntry& entry) {
+        return visitor(entry.resource, entry.calendar);
+    });
 }
 
 AllocationResult ResourceAllocator::allocateResources(const AllocationRequest& request) {
+    OperationScope timing(OperationId::ALLOCATE_RESOURCES);
     AllocationResult result;
     result.success = false;
-    
-    // Validate project exists
-    try {
-        projectManager_.getProject(request.projectId);
-    } catch (const std::runtime_error&) {
-        result.message = "Project not found";
+    std::optional<AllocationPlan> plan = compileAllocation(request, &result.message);
+    if (!plan) {
         return result;
     }
-    
-    // Find matching talents
-    std::vector<std::string> matchingTalentIds = findMatchingTalents(request.requiredSkills);
-    if (matchingTalentIds.size() < request.requiredTeamSize) {
-        result.message = "Insufficient matching talents";
+    return executePlan(*plan);
+}
+
+AllocationResult ResourceAllocator::allocatePlan(const AllocationPlan& plan) {
+    OperationScope timing(OperationId::ALLOCATE_RESOURCES);
+    return executePlan(plan);
+}
+
+std::optional<AllocationPlan> ResourceAllocator::compileAllocation(const AllocationRequest& request,
+                                                                   std::string* error) {
+    auto fail = [error](std::string message) -> std::optional<AllocationPlan> {
+        if (error != nullptr) {
+            *error = std::move(message);
+        }
+        return std::nullopt;
+    };
+    AllocationPlan plan;
+    for (const auto& skill : request.requiredSkills) {
+        std::optional<SkillType> parsed = parseSkillType(skill);
+        if (!parsed) {
+            return fail("Unknown skill: " + skill);
+        }
+        plan.requiredSkills.insert(*parsed);
+    }
+    if (request.requiredTeamSize < 0) {
+        return fail("Invalid team size");
+    }
+    if (!(request.startDate < request.endDate)) {
+        return fail("Invalid allocation window");
+    }
+    plan.projectId = request.projectId;
+    plan.teamSize = static_cast<std::size_t>(request.requiredTeamSize);
+    plan.startDate = request.startDate;
+    plan.endDate = request.endDate;
+    if (request.budget > 0) {
+        plan.budgetCeiling = request.budget;
+    }
+    return plan;
+}
+
+AllocationResult ResourceAllocator::executePlan(const AllocationPlan& plan) {
+    DurableScope scope(log_);
+    AllocationResult result;
+    result.success = false;
+    if (!checkPlan(plan, result)) {
         return result;
     }
-    
-    // Find available resources
-    std::vector<Resource> availableResources = getAvailableResources();
-    std::vector<std::string> allocatedResourceIds;
-    
-    for (const auto& resource : availableResources) {
-        if (isResourceAvailable(resource, request.startDate, request.endDate)) {
-            allocatedResourceIds.push_back(resource.id);
-            resources_[resource.id].currentProjectId = request.projectId;
-            resources_[resource.id].isAvailable = false;
-            resources_[resource.id].lastUsed = std::chrono::system_clock::now();
+
+    for (int attempt = 0; attempt < kMaxAllocationAttempts; ++attempt) {
+        // Collect candidates; no lock is held between here and the commit
+        std::vector<TalentCandidate> talents;
+        if (!chooseTeam(plan, talents, result)) {
+            return result;
+        }
+        std::vector<ResourceCandidate> resources = findResourceCandidates(plan);
+
+        // Validate and commit; a concurrent change to any candidate aborts the attempt
+        if (commitAllocation(plan, talents, resources, result)) {
+            result.success = true;
+            result.message = "Resources allocated successfully";
+            return result;
         }
     }
-    
-    // Allocate talents to project
-    for (size_t i = 0; i < request.requiredTeamSize; ++i) {
-        talentManager_.assignProject(matchingTalentIds[i], request.projectId);
-        result.allocatedTalentIds.push_back(matchingTalentIds[i]);
-    }
-    
-    result.allocatedResourceIds = allocatedResourceIds;
-    result.success = true;
-    result.message = "Resources allocated successfully";
+
+    result.message = "Allocation conflicted with concurrent updates";
     return result;
 }
 
+std::vector<AllocationResult> ResourceAllocator::allocateResourcesBatch(
+    const std::vector<AllocationRequest>& requests) {
+    OperationScope timing(OperationId::ALLOCATE_RESOURCES_BATCH);
+    DurableScope scope(log_);
+    struct PendingRequest {
+        std::size_t request;
+        std::size_t pool;
+        std::size_t teamSize;
+        double hours;
+        std::size_t bandBegin = 0;
+        std::size_t bandEnd = 0;
+        std::vector<std::size_t> chosen;  // Positions in the pool
+        std::vector<std::size_t> pinned;  // Cheapest team, once the optimum broke the budget
+    };
+
+    std::vector<AllocationResult> results(requests.size());
+    std::vector<AllocationPlan> plans(requests.size());
+    std::vector<PendingRequest> pending;
+    std::unordered_map<SkillSet::Mask, std::size_t> poolOfMask;
+    std::vector<SkillSet> poolSkills;
+
+    for (std::size_t i = 0; i < requests.size(); ++i) {
+        results[i].success = false;
+        std::optional<AllocationPlan> plan = compileAllocation(requests[i], &results[i].message);
+        if (!plan || !checkPlan(*plan, results[i])) {
+            continue;
+        }
+        plans[i] = std::move(*plan);
+        auto [poolIt, inserted] = poolOfMask.try_emplace(plans[i].requiredSkills.mask(), poolSkills.size());
+        if (inserted) {
+            poolSkills.push_back(plans[i].requiredSkills);
+        }
+        pending.push_back(PendingRequest{i, poolIt->second, plans[i].teamSize, windowHours(plans[i]), 0, 0, {}, {}});
+    }
+
+    // Requests needing the same skills share one candidate pool. Cost is
+    // rankedCost x hours, so within a pool the longest windows should take the
+    // cheapest talents; each request is slotted into the ranking accordingly
+    // and may only reach kBatchCandidateSlack positions past its slot, which
+    // keeps the assignment graph linear in the batch size.
+    std::vector<std::vector<std::size_t>> requestsOfPool(poolSkills.size());
+    for (std::size_t p = 0; p < pending.size(); ++p) {
+        requestsOfPool[pending[p].pool].push_back(p);
+    }
+    std::vector<std::vector<PooledTalent>> pools(poolSkills.size());
+    std::unordered_map<TalentHandle, std::size_t, HandleHash> nodeOfTalent;
+    for (std::size_t pool = 0; pool < pools.size(); ++pool) {
+        auto& members = requestsOfPool[pool];
+        std::stable_sort(members.begin(), members.end(), [&](std::size_t a, std::size_t b) {
+            return pending[a].hours > pending[b].hours;
+        });
+        std::size_t seats = 0;
+        for (std::size_t p : members) {
+            pending[p].bandBegin = seats > kBatchCandidateSlack ? seats - kBatchCandidateSlack : 0;
+            seats += pending[p].teamSize;
+            pending[p].bandEnd = seats + kBatchCandidateSlack;
+        }
+        if (seats == 0) {
+            continue;
+        }
+
+        auto& candidates = pools[pool];
+        CandidateRanking ranking;
+        ranking.levelFactors = kLevelCostFactors;
+        for (auto& ranked : talentManager_.findRankedCandidates(poolSkills[pool], seats + kBatchCandidateSlack,
+                                                                ranking)) {
+            std::size_t node = nodeOfTalent.try_emplace(ranked.candidate.handle, nodeOfTalent.size()).first->second;
+            candidates.push_back(PooledTalent{std::move(ranked.candidate), ranked.hourlyRate, ranked.cost, node});
+        }
+    }
+
+    // Solve, then re-solve after dropping the requests that could not be
+    // staffed and pinning the ones whose optimal team broke their budget to
+    // their cheapest team, which is the only one that can still fit. A
+    // dropped request may only have lost its band to the other teams, so it
+    // is retried on its own once the batch has committed.
+    std::vector<std::size_t> active(pending.size());
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<std::size_t> retry;
+    for (int round = 0; round < kMaxBatchSolveRounds && !active.empty(); ++round) {
+        AssignmentProblem problem;
+        problem.talentCount = nodeOfTalent.size();
+        for (std::size_t a = 0; a < active.size(); ++a) {
+            const PendingRequest& entry = pending[active[a]];
+            const AllocationPlan& plan = plans[entry.request];
+            const auto& candidates = pools[entry.pool];
+            problem.demand.push_back(entry.teamSize);
+            auto addEdge = [&](std::size_t pos) {
+                problem.edges.push_back(AssignmentEdge{a, candidates[pos].node,
+                                                       candidates[pos].rankedCost * entry.hours});
+            };
+            if (!entry.pinned.empty()) {
+                std::for_each(entry.pinned.begin(), entry.pinned.end(), addEdge);
+                continue;
+            }
+            for (std::size_t pos = entry.bandBegin; pos < std::min(entry.bandEnd, candidates.size()); ++pos) {
+                if (candidates[pos].hourlyRate * entry.hours > plan.budgetCeiling) {
+                    continue;
+                }
+                addEdge(pos);
+            }
+        }
+        auto assignment = solveMinCostAssignment(problem);
+
+        std::vector<std::size_t> staffed;
+        bool settled = true;
+        for (std::size_t a = 0; a < active.size(); ++a) {
+            PendingRequest& entry = pending[active[a]];
+            const AllocationPlan& plan = plans[entry.request];
+            const auto& candidates = pools[entry.pool];
+            std::size_t bandEnd = std::min(entry.bandEnd, candidates.size());
+            entry.chosen.clear();
+            double billed = 0.0;
+            for (std::size_t node : assignment[a]) {
+                for (std::size_t pos = entry.bandBegin; pos < bandEnd; ++pos) {
+                    if (candidates[pos].node == node) {
+                        entry.chosen.push_back(pos);
+                        billed += candidates[pos].hourlyRate * entry.hours;
+                        break;
+                    }
+                }
+            }
+            if (entry.chosen.size() < entry.teamSize) {
+                retry.push_back(active[a]);
+                settled = false;
+                continue;
+            }
+            if (billed <= plan.budgetCeiling) {
+                staffed.push_back(active[a]);
+                continue;
+            }
+
+            settled = false;
+            if (entry.pinned.empty()) {
+                std::vector<std::size_t> cheapest;
+                for (std::size_t pos = entry.bandBegin; pos < bandEnd; ++pos) {
+                    cheapest.push_back(pos);
+                }
+                std::partial_sort(cheapest.begin(), cheapest.begin() + entry.teamSize, cheapest.end(),
+                                  [&](std::size_t x, std::size_t y) {
+                                      return candidates[x].hourlyRate < candidates[y].hourlyRate;
+                                  });
+                cheapest.resize(entry.teamSize);
+                double cheapestBill = 0.0;
+                for (std::size_t pos : cheapest) {
+                    cheapestBill += candidates[pos].hourlyRate * entry.hours;
+                }
+                if (cheapestBill <= plan.budgetCeiling) {
+                    entry.pinned = std::move(cheapest);
+                    entry.chosen.clear();
+                    staffed.push_back(active[a]);
+                    continue;
+                }
+            }
+            results[entry.request].message = "Allocation exceeds budget";
+        }
+        active = std::move(staffed);
+        if (settled) {
+            break;
+        }
+    }
+
+    // Commit in request order with the same optimistic machinery as single
+    // requests; one that loses a race falls back to allocateResources
+    std::sort(active.begin(), active.end());
+    for (std::size_t p : active) {
+        const PendingRequest& entry = pending[p];
+        const AllocationPlan& plan = plans[entry.request];
+        AllocationResult& result = results[entry.request];
+        if (entry.chosen.size() < entry.teamSize) {
+            // Pinned in the last round and never re-solved
+            retry.push_back(p);
+            continue;
+        }
+        std::vector<TalentCandidate> talents;
+        for (std::size_t pos : entry.chosen) {
+            talents.push_back(pools[entry.pool][pos].candidate);
+        }
+        if (commitAllocation(plan, talents, findResourceCandidates(plan), result)) {
+            result.success = true;
+            result.message = "Resources allocated successfully";
+        } else {
+            result = executePlan(plan);
+        }
+    }
+
+    // The batch left these unstaffed without showing a real shortage; they
+    // are allocated like allocateResources, after the teams it did staff
+    std::sort(retry.begin(), retry.end());
+    for (std::size_t p : retry) {
+        results[pending[p].request] = executePlan(plans[pending[p].request]);
+    }
+    timing.setResultSize(results.size());
+    return results;
+}
+
 bool ResourceAllocator::deallocateResources(const std::string& projectId) {
+    OperationScope timing(OperationId::DEALLOCATE_RESOURCES);
+    DurableScope scope(log_);
     bool success = false;
-    
-    for (auto& pair : resources_) {
-        if (pair.second.currentProjectId == projectId) {
-            pair.second.currentProjectId = "";
-            pair.second.isAvailable = true;
+
+    for (ResourceHandle handle : projectResources_.members(projectId)) {
+        auto& shard = resources_.shardOf(handle);
+        WriteLock lock(shard.mutex);
+        ResourceEntry* entry = shard.find(handle);
+        projectResources_.unlink(projectId, handle);
+        if (entry == nullptr) {
+            continue;
+        }
+        bool changed = releaseProjectBookings(shard, handle, *entry, projectId) > 0;
+        if (entry->resource.currentProjectId == projectId) {
+            entry->resource.currentProjectId = "";
+            entry->resource.isAvailable = true;
+            changed = true;
+        }
+        if (changed) {
+            ++entry->version;
+            logResource(*entry);
             success = true;
         }
     }
-    
+
     return success;
 }
 
 bool ResourceAllocator::updateResourceAvailability(const std::string& resourceId, bool isAvailable) {
-    if (resources_.find(resourceId) == resources_.end()) {
+    OperationScope timing(OperationId::UPDATE_RESOURCE_AVAILABILITY);
+    DurableScope scope(log_);
+    auto& shard = resources_.shardFor(resourceId);
+    WriteLock lock(shard.mutex);
+    ResourceHandle handle = shard.findHandle(resourceId);
+    ResourceEntry* entry = shard.find(handle);
+    if (entry == nullptr) {
         return false;
     }
-    resources_[resourceId].isAvailable = isAvailable;
+    entry->resource.isAvailable = isAvailable;
+    ++entry->version;
+    markResourceChanged(handle);
+    logResource(*entry);
     return true;
 }
 
 std::vector<Resource> ResourceAllocator::getAvailableResources() {
+    OperationScope timing(OperationId::GET_AVAILABLE_RESOURCES);
     std::vector<Resource> result;
-    for (const auto& pair : resources_) {
-        if (pair.second.isAvailable) {
-            result.push_back(pair.second);
+    forEachAvailableResource([&](const Resource& resource) {
+        result.push_back(resource);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+void ResourceAllocator::forEachAvailableResource(const std::function<bool(const Resource&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_AVAILABLE_RESOURCE);
+    forEachEntry([&](const ResourceEntry& entry) {
+        return !entry.resource.isAvailable || visitor(entry.resource);
+    });
+}
+
+bool ResourceAllocator::isResourceFree(const std::string& resourceId,
+                                       const std::chrono::system_clock::time_point& startDate,
+                                       const std::chrono::system_clock::time_point& endDate) const {
+    OperationScope timing(OperationId::IS_RESOURCE_FREE);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    return entry != nullptr && isResourceAvailable(*entry, startDate, endDate);
+}
+
+std::vector<std::string> ResourceAllocator::findFreeResources(const std::string& type,
+                                                              const std::chrono::system_clock::time_point& startDate,
+                                                              const std::chrono::system_clock::time_point& endDate) const {
+    OperationScope timing(OperationId::FIND_FREE_RESOURCES);
+    std::vector<std::string> result;
+    std::optional<Symbol> typeSymbol = Symbol::find(type);
+    if (!typeSymbol) {
+        return result;
+    }
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        const auto& shard = resources_.shard(i);
+        ReadLock lock(shard.mutex);
+        auto typeIt = shard.index.byType.find(*typeSymbol);
+        if (typeIt == shard.index.byType.end()) {
+            continue;
+        }
+        for (ResourceHandle handle : typeIt->second) {
+            const ResourceEntry& entry = *shard.find(handle);
+            if (isResourceAvailable(entry, startDate, endDate)) {
+                result.push_back(entry.resource.id);
+            }
         }
     }
+    timing.setResultSize(result.size());
     return result;
 }
 
+const BookingCalendar* ResourceAllocator::findBookingCalendar(const std::string& resourceId) const {
+    OperationScope timing(OperationId::FIND_BOOKING_CALENDAR);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    return entry == nullptr ? nullptr : &entry->calendar;
+}
+
 std::vector<Resource> ResourceAllocator::getResourcesByProject(const std::string& projectId) {
+    OperationScope timing(OperationId::GET_RESOURCES_BY_PROJECT);
     std::vector<Resource> result;
-    for (const auto& pair : resources_) {
-        if (pair.second.currentProjectId == projectId) {
-            result.push_back(pair.second);
-        }
-    }
+    forEachResourceOfProject(projectId, [&](const Resource& resource) {
+        result.push_back(resource);
+        return true;
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
 std::vector<Resource> ResourceAllocator::getResourcesByType(const std::string& type) {
+    OperationScope timing(OperationId::GET_RESOURCES_BY_TYPE);
     std::vector<Resource> result;
-    for (const auto& pair : resources_) {
-        if (pair.second.type == type) {
-            result.push_back(pair.second);
+    forEachResourceOfType(type, [&](const Resource& resource) {
+        result.push_back(resource);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+void ResourceAllocator::forEachResourceOfProject(const std::string& projectId,
+                                                 const std::function<bool(const Resource&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_RESOURCE_OF_PROJECT);
+    for (ResourceHandle handle : projectResources_.members(projectId)) {
+        const auto& shard = resources_.shardOf(handle);
+        ReadLock lock(shard.mutex);
+        // Rechecked under the shard lock, as the index may be a step behind
+        const ResourceEntry* entry = shard.find(handle);
+        if (entry != nullptr && holdsProject(*entry, projectId) && !visitor(entry->resource)) {
+            return;
         }
     }
-    return result;
 }
 
-void ResourceAllocator::optimizeResourceAllocation() {
-    // Implement resource optimization logic
-    // This could include:
-    // 1. Balancing resource utilization
-    // 2. Minimizing resource conflicts
-    // 3. Optimizing for cost efficiency
-    // 4. Improving resource availability
+void ResourceAllocator::forEachResourceOfType(const std::string& type,
+                                              const std::function<bool(const Resource&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_RESOURCE_OF_TYPE);
+    // A type that was never interned has no resources
+    std::optional<Symbol> typeSymbol = Symbol::find(type);
+    if (!typeSymbol) {
+        return;
+    }
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        const auto& shard = resources_.shard(i);
+        ReadLock lock(shard.mutex);
+        auto typeIt = shard.index.byType.find(*typeSymbol);
+        if (typeIt == shard.index.byType.end()) {
+            continue;
+        }
+        for (ResourceHandle handle : typeIt->second) {
+            if (!visitor(shard.find(handle)->resource)) {
+                return;
+            }
+        }
+    }
 }
 
-std::vector<std::string> ResourceAllocator::getUnderutilizedResources() {
-    std::vector<std::string> result;
-    for (const auto& pair : resources_) {
-        if (calculateResourceUtilization(pair.first) < 0.3) { // 30% utilization threshold
-            result.push_back(pair.first);
+std::size_t ResourceAllocator::optimizeResourceAllocation() {
+    OperationScope timing(OperationId::OPTIMIZE_RESOURCE_ALLOCATION);
+    return optimizeResourceAllocation(std::chrono::microseconds::max());
+}
+
+std::size_t ResourceAllocator::optimizeResourceAllocation(std::chrono::microseconds timeBudget) {
+    OperationScope timing(OperationId::OPTIMIZE_RESOURCE_ALLOCATION);
+    DurableScope scope(log_);
+    auto started = std::chrono::steady_clock::now();
+    auto passDeadline = timeBudget == std::chrono::microseconds::max()
+                            ? std::chrono::steady_clock::time_point::max()
+                            : started + timeBudget;
+
+    // Move the utilization window of shards not touched yet today, so
+    // resources that a new day made overutilized are queued below
+    auto today = UtilizationHistory::bucketOf(std::chrono::system_clock::now());
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        auto& shard = resources_.shard(i);
+        WriteLock lock(shard.mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            slideUtilizationWindow(shard, today);
         }
     }
-    return result;
+
+    std::vector<ResourceHandle> work;
+    {
+        std::lock_guard<std::mutex> lock(optimizerMutex_);
+        auto now = std::chrono::system_clock::now();
+        while (!scheduledChecks_.empty() && !(now < scheduledChecks_.top().first)) {
+            dirtyResources_.insert(scheduledChecks_.top().second);
+            scheduledChecks_.pop();
+        }
+        work.assign(dirtyResources_.begin(), dirtyResources_.end());
+        dirtyResources_.clear();
+    }
+
+    std::vector<ResourceHandle> deferred;
+    std::size_t changed = 0;
+    for (std::size_t i = 0; i < work.size(); ++i) {
+        if (!(std::chrono::steady_clock::now() < passDeadline)) {
+            deferred.insert(deferred.end(), work.begin() + i, work.end());
+            break;
+        }
+        switch (rebalanceResource(work[i])) {
+        case RebalanceOutcome::CHANGED:
+            ++changed;
+            break;
+        case RebalanceOutcome::CONTENDED:
+        case RebalanceOutcome::UNRESOLVED:
+            deferred.push_back(work[i]);
+            break;
+        case RebalanceOutcome::SETTLED:
+            break;
+        }
+    }
+
+    if (!deferred.empty()) {
+        std::lock_guard<std::mutex> lock(optimizerMutex_);
+        dirtyResources_.insert(deferred.begin(), deferred.end());
+    }
+    return changed;
 }
 
-std::vector<std::string> ResourceAllocator::getOverutilizedResources() {
-    std::vector<std::string> result;
-    for (const auto& pair : resources_) {
-        if (calculateResourceUtilization(pair.first) > 0.9) { // 90% utilization threshold
-            result.push_back(pair.first);
+bool ResourceAllocator::startBackgroundOptimizer(std::chrono::milliseconds interval,
+                                                 std::chrono::microseconds timeBudget) {
+    std::lock_guard<std::mutex> control(optimizerControlMutex_);
+    if (optimizerThread_.joinable()) {
+        return false;
+    }
+    optimizerStopping_ = false;
+    optimizerThread_ = std::thread([this, interval, timeBudget] {
+        std::unique_lock<std::mutex> lock(optimizerWakeupMutex_);
+        while (!optimizerWakeup_.wait_for(lock, interval, [this] { return optimizerStopping_; })) {
+            lock.unlock();
+            optimizeResourceAllocation(timeBudget);
+            lock.lock();
         }
+    });
+    return true;
+}
+
+void ResourceAllocator::stopBackgroundOptimizer() {
+    std::lock_guard<std::mutex> control(optimizerControlMutex_);
+    if (!optimizerThread_.joinable()) {
+        return;
     }
+    {
+        std::lock_guard<std::mutex> lock(optimizerWakeupMutex_);
+        optimizerStopping_ = true;
+    }
+    optimizerWakeup_.notify_all();
+    optimizerThread_.join();
+}
+
+std::vector<std::string> ResourceAllocator::getUnderutilizedResources() {
+    OperationScope timing(OperationId::GET_UNDERUTILIZED_RESOURCES);
+    std::vector<std::string> result = resourcesInBand(UtilizationBand::UNDER);
+    timing.setResultSize(result.size());
+    return result;
+}
+
+std::vector<std::string> ResourceAllocator::getOverutilizedResources() {
+    OperationScope timing(OperationId::GET_OVERUTILIZED_RESOURCES);
+    std::vector<std::string> result = resourcesInBand(UtilizationBand::OVER);
+    timing.setResultSize(result.size());
     return result;
 }
 
-bool ResourceAllocator::isResourceAvailable(const Resource& resource,
+double ResourceAllocator::getResourceUtilization(const std::string& resourceId,
+                                                 const std::chrono::system_clock::time_point& from,
+                                                 const std::chrono::system_clock::time_point& to) const {
+    OperationScope timing(OperationId::GET_RESOURCE_UTILIZATION);
+    const auto& shard = resources_.shardFor(resourceId);
+    ReadLock lock(shard.mutex);
+    const ResourceEntry* entry = shard.find(resourceId);
+    if (entry == nullptr) {
+        throw std::runtime_error("Resource not found");
+    }
+    if (!(from < to)) {
+        return 0.0;
+    }
+    return std::chrono::duration<double>(entry->history.bookedWithin(from, to)) /
+           std::chrono::duration<double>(to - from);
+}
+
+bool ResourceAllocator::isResourceAvailable(const ResourceEntry& entry,
                                           const std::chrono::system_clock::time_point& startDate,
-                                          const std::chrono::system_clock::time_point& endDate) {
-    if (!resource.isAvailable) {
+                                          const std::chrono::system_clock::time_point& endDate) const {
+    // An unavailable resource is refused for every window, unless it is only
+    // busy with a booking of its current project; then the calendar decides
+    if (!entry.resource.isAvailable && (entry.resource.currentProjectId.empty() ||
+                                        !entry.calendar.hasProject(entry.resource.currentProjectId))) {
         return false;
     }
     
-    // Check if resource is already allocated during the requested time period
-    if (!resource.currentProjectId.empty()) {
-        try {
-            Project currentProject = projectManager_.getProject(resource.currentProjectId);
-            if (currentProject.deadline > startDate) {
-                return false;
+    // Check if resource is already booked during the requested time period
+    return entry.calendar.isFree(startDate, endDate);
+}
+
+void ResourceAllocator::unindexResourceType(ShardIndex& index, ResourceHandle handle, Symbol type) {
+    auto typeIt = index.byType.find(type);
+    if (typeIt != index.byType.end()) {
+        typeIt->second.erase(handle);
+        if (typeIt->second.empty()) {
+            index.byType.erase(typeIt);
+        }
+    }
+}
+
+template <typename Visitor>
+void ResourceAllocator::forEachEntry(Visitor&& visitor) const {
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        const auto& shard = resources_.shard(i);
+        ReadLock lock(shard.mutex);
+        bool keepGoing = true;
+        shard.forEach([&](ResourceHandle, const ResourceEntry& entry) {
+            keepGoing = visitor(entry);
+            return keepGoing;
+        });
+        if (!keepGoing) {
+            return;
+        }
+    }
+}
+
+bool ResourceAllocator::holdsProject(const ResourceEntry& entry, const std::string& projectId) {
+    return !projectId.empty() &&
+           (entry.resource.currentProjectId == projectId || entry.calendar.hasProject(projectId));
+}
+
+void ResourceAllocator::linkProjects(ResourceHandle handle, const ResourceEntry& entry) {
+    if (!entry.resource.currentProjectId.empty()) {
+        projectResources_.link(entry.resource.currentProjectId, handle);
+    }
+    entry.calendar.forEachBooking([&](const Booking& booking) {
+        projectResources_.link(booking.projectId, handle);
+        return true;
+    });
+}
+
+void ResourceAllocator::unlinkProjects(ResourceHandle handle, const ResourceEntry& entry) {
+    if (!entry.resource.currentProjectId.empty()) {
+        projectResources_.unlink(entry.resource.currentProjectId, handle);
+    }
+    entry.calendar.forEachBooking([&](const Booking& booking) {
+        projectResources_.unlink(booking.projectId, handle);
+        return true;
+    });
+}
+
+void ResourceAllocator::syncProjectLink(ResourceHandle handle, const ResourceEntry& entry,
+                                        const std::string& projectId) {
+    if (projectId.empty()) {
+        return;
+    }
+    if (holdsProject(entry, projectId)) {
+        projectResources_.link(projectId, handle);
+    } else {
+        projectResources_.unlink(projectId, handle);
+    }
+}
+
+bool ResourceAllocator::checkPlan(const AllocationPlan& plan, AllocationResult& result) const {
+    // Validate project exists
+    if (!projectManager_.containsProject(plan.projectId)) {
+        result.message = "Project not found";
+        return false;
+    }
+
+    // A reused plan may have been given a new window
+    if (!(plan.startDate < plan.endDate)) {
+        result.message = "Invalid allocation window";
+        return false;
+    }
+    return true;
+}
+
+bool ResourceAllocator::chooseTeam(const AllocationPlan& plan, std::vector<TalentCandidate>& team,
+                                   AllocationResult& result) const {
+    double hours = windowHours(plan);
+    auto billed = [hours](const std::vector<RankedCandidate>& ranked) {
+        double total = 0.0;
+        for (const auto& talent : ranked) {
+            total += talent.hourlyRate * hours;
+        }
+        return total;
+    };
+    // Nobody billing more than the whole budget alone can be on the team
+    CandidateRanking ranking;
+    ranking.levelFactors = kLevelCostFactors;
+    ranking.loadFactor = kLoadCostFactor;
+    ranking.maxHourlyRate = plan.budgetCeiling / hours;
+    std::vector<RankedCandidate> ranked =
+        talentManager_.findRankedCandidates(plan.requiredSkills, plan.teamSize, ranking);
+    if (ranked.size() < plan.teamSize) {
+        bool priced = std::isfinite(ranking.maxHourlyRate) &&
+                      talentManager_.findRankedCandidates(plan.requiredSkills, plan.teamSize, CandidateRanking())
+                              .size() == plan.teamSize;
+        result.message = priced ? "Allocation exceeds budget" : "Insufficient matching talents";
+        return false;
+    }
+    if (billed(ranked) > plan.budgetCeiling) {
+        // The best-ranked team breaks the budget; the cheapest one is the
+        // only team that can still fit
+        CandidateRanking byRate;
+        byRate.maxHourlyRate = ranking.maxHourlyRate;
+        ranked = talentManager_.findRankedCandidates(plan.requiredSkills, plan.teamSize, byRate);
+        if (ranked.size() < plan.teamSize || billed(ranked) > plan.budgetCeiling) {
+            result.message = "Allocation exceeds budget";
+            return false;
+        }
+    }
+    team.clear();
+    for (auto& talent : ranked) {
+        team.push_back(std::move(talent.candidate));
+    }
+    return true;
+}
+
+std::vector<ResourceAllocator::ResourceCandidate>
+ResourceAllocator::findResourceCandidates(const AllocationPlan& plan) const {
+    std::vector<ResourceCandidate> result;
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        const auto& shard = resources_.shard(i);
+        ReadLock lock(shard.mutex);
+        shard.forEach([&](ResourceHandle handle, const ResourceEntry& entry) {
+            if (isResourceAvailable(entry, plan.startDate, plan.endDate)) {
+                result.push_back(ResourceCandidate{handle, entry.version});
             }
-        } catch (const std::runtime_error&) {
-            // If project not found, consider resource available
             return true;
+        });
+    }
+    return result;
+}
+
+bool ResourceAllocator::commitAllocation(const AllocationPlan& plan,
+                                         const std::vector<TalentCandidate>& talents,
+                                         const std::vector<ResourceCandidate>& resources,
+                                         AllocationResult& result) {
+    std::vector<std::size_t> shardNumbers;
+    shardNumbers.reserve(resources.size());
+    for (const auto& candidate : resources) {
+        shardNumbers.push_back(resources_.shardNumberOf(candidate.handle));
+    }
+    auto locks = resources_.lockExclusive(std::move(shardNumbers));
+
+    for (const auto& candidate : resources) {
+        const ResourceEntry* entry = resources_.shardOf(candidate.handle).find(candidate.handle);
+        if (entry == nullptr || entry->version != candidate.version) {
+            return false;
         }
     }
-    
+
+    // Talents validate and commit under their own shard locks, taken after the
+    // resource locks; nothing has been written yet if this fails
+    if (!talentManager_.commitProjectAssignment(talents, plan.projectId)) {
+        return false;
+    }
+
+    result.allocatedTalentIds.clear();
+    for (const auto& candidate : talents) {
+        result.allocatedTalentIds.push_back(candidate.id);
+    }
+    // The project side of the same assignment; a project deleted meanwhile
+    // simply has no team to record it on
+    projectManager_.assignTeamMembers(plan.projectId, result.allocatedTalentIds);
+
+    result.allocatedResourceIds.clear();
+    auto now = std::chrono::system_clock::now();
+    for (const auto& candidate : resources) {
+        auto& shard = resources_.shardOf(candidate.handle);
+        ResourceEntry& entry = *shard.find(candidate.handle);
+        Resource& resource = entry.resource;
+        entry.calendar.book(plan.startDate, plan.endDate, plan.projectId);
+        entry.history.add(plan.startDate, plan.endDate);
+        updateUtilization(shard, candidate.handle, entry);
+        projectResources_.link(plan.projectId, candidate.handle);
+        ++entry.version;
+        result.allocatedResourceIds.push_back(resource.id);
+        // Only a window that has already started occupies the resource now;
+        // later windows just hold their slot in the calendar
+        if (!(now < plan.startDate)) {
+            resource.currentProjectId = plan.projectId;
+            resource.isAvailable = false;
+            resource.lastUsed = now;
+            markResourceChanged(candidate.handle);
+        }
+        logResource(entry);
+    }
     return true;
 }
 
-std::vector<std::string> ResourceAllocator::findMatchingTalents(const std::vector<std::string>& requiredSkills) {
+void ResourceAllocator::logResource(const ResourceEntry& entry) {
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::RESOURCE, ChangeType::PUT, entry.resource.id);
+    }
+    if (log_ == nullptr) {
+        return;
+    }
+    std::vector<Booking> bookings;
+    bookings.reserve(entry.calendar.size());
+    entry.calendar.forEachBooking([&](const Booking& booking) {
+        bookings.push_back(booking);
+        return true;
+    });
+    DurableScope::note(log_->putResource(entry.resource, bookings));
+}
+
+void ResourceAllocator::markResourceChanged(ResourceHandle handle) {
+    std::lock_guard<std::mutex> lock(optimizerMutex_);
+    dirtyResources_.insert(handle);
+}
+
+ResourceAllocator::ResourceEntry ResourceAllocator::makeEntry(const Resource& resource) const {
+    return ResourceEntry{resource, BookingCalendar(resources_.resource()), 0,
+                         UtilizationHistory(resources_.resource())};
+}
+
+void ResourceAllocator::updateUtilization(Store::Shard& shard, ResourceHandle handle, ResourceEntry& entry) {
+    auto today = UtilizationHistory::bucketOf(std::chrono::system_clock::now());
+    if (shard.index.windowStart != today) {
+        // Recomputes every entry of the shard, this one included
+        slideUtilizationWindow(shard, today);
+        return;
+    }
+    refreshUtilization(shard, handle, entry);
+}
+
+void ResourceAllocator::refreshUtilization(Store::Shard& shard, ResourceHandle handle, ResourceEntry& entry) {
+    auto windowStart = shard.index.windowStart;
+    entry.windowBooked = entry.history.bookedIn(windowStart, windowStart + kUtilizationWindowDays);
+    double utilization = std::chrono::duration<double>(entry.windowBooked) /
+                         std::chrono::duration<double>(kUtilizationWindow);
+    UtilizationBand band = utilization < kUnderutilizedThreshold  ? UtilizationBand::UNDER
+                           : utilization > kOverutilizedThreshold ? UtilizationBand::OVER
+                                                                  : UtilizationBand::NORMAL;
+    if (band == entry.band) {
+        return;
+    }
+    // Moves the set node rather than reallocating it
+    auto node = shard.index.byBand[static_cast<std::size_t>(entry.band)].extract(handle);
+    shard.index.byBand[static_cast<std::size_t>(band)].insert(std::move(node));
+    entry.band = band;
+    if (band == UtilizationBand::OVER) {
+        markResourceChanged(handle);
+    }
+}
+
+void ResourceAllocator::slideUtilizationWindow(Store::Shard& shard, UtilizationHistory::Bucket today) {
+    if (shard.index.windowStart == today) {
+        return;
+    }
+    shard.index.windowStart = today;
+    shard.forEachMutable([&](ResourceHandle handle, ResourceEntry& entry) {
+        refreshUtilization(shard, handle, entry);
+        return true;
+    });
+}
+
+std::vector<std::string> ResourceAllocator::resourcesInBand(UtilizationBand band) {
+    auto today = UtilizationHistory::bucketOf(std::chrono::system_clock::now());
     std::vector<std::string> result;
-    std::vector<Talent> availableTalents = talentManager_.getAvailableTalents();
-    
-    for (const auto& talent : availableTalents) {
-        bool hasAllSkills = true;
-        for (const auto& skill : requiredSkills) {
-            // Convert skill string to SkillType enum
-            // This is a simplified version - in reality, you'd need proper skill mapping
-            SkillType skillType = static_cast<SkillType>(std::stoi(skill));
-            if (talent.skills.find(skillType) == talent.skills.end()) {
-                hasAllSkills = false;
-                break;
-            }
+    auto collect = [&](const Store::Shard& shard) {
+        for (ResourceHandle handle : shard.index.byBand[static_cast<std::size_t>(band)]) {
+            result.push_back(shard.find(handle)->resource.id);
         }
-        if (hasAllSkills) {
-            result.push_back(talent.id);
+    };
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        auto& shard = resources_.shard(i);
+        {
+            ReadLock lock(shard.mutex);
+            if (shard.index.windowStart == today) {
+                collect(shard);
+                continue;
+            }
         }
+        // First query of the day on this shard
+        WriteLock lock(shard.mutex);
+        slideUtilizationWindow(shard, today);
+        collect(shard);
     }
-    
     return result;
 }
 
-double ResourceAllocator::calculateResourceUtilization(const std::string& resourceId) {
-    if (resources_.find(resourceId) == resources_.end()) {
-        return 0.0;
+std::size_t ResourceAllocator::releaseProjectBookings(Store::Shard& shard, ResourceHandle handle,
+                                                      ResourceEntry& entry, const std::string& projectId) {
+    if (!entry.calendar.hasProject(projectId)) {
+        return 0;
     }
-    
-    const Resource& resource = resources_[resourceId];
+    // Time already served stays in the history
     auto now = std::chrono::system_clock::now();
-    
-    // Calculate utilization based on time allocated to projects
-    // This is a simplified version - in reality, you'd need more sophisticated metrics
-    if (resource.currentProjectId.empty()) {
-        return 0.0;
+    std::size_t released = 0;
+    entry.calendar.forEachBooking([&](const Booking& booking) {
+        if (booking.projectId == projectId) {
+            entry.history.remove(std::max(booking.startDate, now), booking.endDate);
+            ++released;
+        }
+        return true;
+    });
+    entry.calendar.releaseProject(projectId);
+    updateUtilization(shard, handle, entry);
+    return released;
+}
+
+ResourceAllocator::RebalanceOutcome ResourceAllocator::rebalanceResource(ResourceHandle handle) {
+    auto now = std::chrono::system_clock::now();
+    ResourceCandidate source{handle, 0};
+    Symbol type;
+    Booking booking;
+    std::chrono::system_clock::duration load{0};
+    {
+        auto& shard = resources_.shardOf(handle);
+        WriteLock lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return RebalanceOutcome::CONTENDED;
+        }
+        ResourceEntry* entry = shard.find(handle);
+        if (entry == nullptr || entry->resource.currentProjectId.empty()) {
+            return RebalanceOutcome::SETTLED;
+        }
+        Resource& resource = entry->resource;
+
+        bool projectActive = false;
+        projectManager_.withProject(resource.currentProjectId, [&](const Project& project) {
+            projectActive = project.status != ProjectStatus::COMPLETED &&
+                            project.status != ProjectStatus::CANCELLED;
+        });
+        const Booking* current = entry->calendar.bookingAt(now);
+        bool bookingCurrent = current != nullptr && current->projectId == resource.currentProjectId;
+
+        // Release allocations to projects that are gone or finished, and to
+        // ones whose booking has run out
+        if (!projectActive || (!bookingCurrent && entry->calendar.hasProject(resource.currentProjectId))) {
+            std::string projectId = std::move(resource.currentProjectId);
+            if (!projectActive) {
+                releaseProjectBookings(shard, handle, *entry, projectId);
+            }
+            resource.currentProjectId.clear();
+            resource.isAvailable = true;
+            syncProjectLink(handle, *entry, projectId);
+            ++entry->version;
+            logResource(*entry);
+            return RebalanceOutcome::CHANGED;
+        }
+        // Assigned by hand, without a booking the optimizer could move
+        if (!bookingCurrent) {
+            return RebalanceOutcome::SETTLED;
+        }
+
+        // What is left of the booking inside the window; a resource this
+        // booking alone overutilizes would only pass it on to another one
+        auto windowEnd = UtilizationHistory::bucketStart(shard.index.windowStart + kUtilizationWindowDays);
+        load = std::max(std::min(current->endDate, windowEnd) - now, std::chrono::system_clock::duration::zero());
+        bool movable = std::chrono::duration<double>(load) <=
+                       std::chrono::duration<double>(kUtilizationWindow) * kOverutilizedThreshold;
+        if (entry->band != UtilizationBand::OVER || !movable) {
+            // Come back when the booking runs out, to release it
+            std::lock_guard<std::mutex> scheduleLock(optimizerMutex_);
+            scheduledChecks_.push({current->endDate, handle});
+            return RebalanceOutcome::SETTLED;
+        }
+
+        source.version = entry->version;
+        type = resource.type;
+        booking = *current;
     }
-    
-    try {
-        Project currentProject = projectManager_.getProject(resource.currentProjectId);
-        auto totalDuration = currentProject.deadline - resource.lastUsed;
-        auto elapsedDuration = now - resource.lastUsed;
-        
-        return std::min(1.0, std::max(0.0, 
-            std::chrono::duration<double>(elapsedDuration).count() / 
-            std::chrono::duration<double>(totalDuration).count()));
-    } catch (const std::runtime_error&) {
-        return 0.0;
+
+    ResourceCandidate target;
+    if (!findIdleResource(type, booking, load, handle, target)) {
+        return RebalanceOutcome::UNRESOLVED;
+    }
+    return handOver(source, target, booking);
+}
+
+bool ResourceAllocator::findIdleResource(Symbol type, const Booking& booking,
+                                         std::chrono::system_clock::duration load,
+                                         ResourceHandle exclude, ResourceCandidate& idle) const {
+    auto now = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < resources_.shardCount(); ++i) {
+        const auto& shard = resources_.shard(i);
+        ReadLock lock(shard.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            continue;
+        }
+        auto typeIt = shard.index.byType.find(type);
+        if (typeIt == shard.index.byType.end()) {
+            continue;
+        }
+        for (ResourceHandle handle : typeIt->second) {
+            const ResourceEntry& entry = *shard.find(handle);
+            // Taking over `load` must not make the resource overutilized itself
+            auto booked = std::chrono::duration<double>(entry.windowBooked + load);
+            if (handle != exclude && entry.resource.isAvailable && entry.resource.currentProjectId.empty() &&
+                booked <= std::chrono::duration<double>(kUtilizationWindow) * kOverutilizedThreshold &&
+                entry.calendar.isFree(now, booking.endDate)) {
+                idle = ResourceCandidate{handle, entry.version};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+ResourceAllocator::RebalanceOutcome ResourceAllocator::handOver(ResourceCandidate source, ResourceCandidate target,
+                                                                const Booking& booking) {
+    std::size_t first = resources_.shardNumberOf(source.handle);
+    std::size_t second = resources_.shardNumberOf(target.handle);
+    if (second < first) {
+        std::swap(first, second);
+    }
+    WriteLock firstLock(resources_.shard(first).mutex, std::try_to_lock);
+    if (!firstLock.owns_lock()) {
+        return RebalanceOutcome::CONTENDED;
     }
+    WriteLock secondLock;
+    if (second != first) {
+        secondLock = WriteLock(resources_.shard(second).mutex, std::try_to_lock);
+        if (!secondLock.owns_lock()) {
+            return RebalanceOutcome::CONTENDED;
+        }
+    }
+
+    auto& fromShard = resources_.shardOf(source.handle);
+    auto& toShard = resources_.shardOf(target.handle);
+    ResourceEntry* from = fromShard.find(source.handle);
+    ResourceEntry* to = toShard.find(target.handle);
+    if (from == nullptr || to == nullptr || from->version != source.version || to->version != target.version) {
+        return RebalanceOutcome::CONTENDED;
+    }
+    auto now = std::chrono::system_clock::now();
+    if (!(now < booking.endDate)) {
+        return RebalanceOutcome::CONTENDED;
+    }
+
+    // The source keeps the part of the booking it already served
+    from->calendar.release(booking.startDate);
+    if (booking.startDate < now) {
+        from->calendar.book(booking.startDate, now, booking.projectId);
+    }
+    from->history.remove(now, booking.endDate);
+    updateUtilization(fromShard, source.handle, *from);
+    from->resource.currentProjectId.clear();
+    from->resource.isAvailable = true;
+    syncProjectLink(source.handle, *from, booking.projectId);
+    ++from->version;
+
+    to->calendar.book(now, booking.endDate, booking.projectId);
+    to->history.add(now, booking.endDate);
+    updateUtilization(toShard, target.handle, *to);
+    to->resource.currentProjectId = booking.projectId;
+    to->resource.isAvailable = false;
+    projectResources_.link(booking.projectId, target.handle);
+    to->resource.lastUsed = now;
+    ++to->version;
+    markResourceChanged(target.handle);
+    logResource(*from);
+    logResource(*to);
+    return RebalanceOutcome::CHANGED;
 }
 
 } // namespace imagined 
\ No newline at end of file
@@ -1,18 +1,38 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
-#include <map>
+#include <set>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include "AssignmentIndex.hpp"
+#include "BookingCalendar.hpp"
+#include "Handle.hpp"
+#include "ChangeFeed.hpp"
+#include "MutationLog.hpp"
+#include "ShardedStore.hpp"
+#include "Symbol.hpp"
 #include "ProjectManager.hpp"
 #include "TalentManager.hpp"
+#include "UtilizationHistory.hpp"
 
 namespace imagined {
 
 struct Resource {
     std::string id;
     std::string name;
-    std::string type;
+    Symbol type;
     bool isAvailable;
     std::chrono::system_clock::time_point lastUsed;
     std::string currentProjectId;
@@ -34,9 +54,45 @@ struct AllocationResult {
     std::string message;
 };
 
+// An AllocationRequest validated and reduced to what allocation works on:
+// the skills folded into one mask, the budget into a ceiling on each team's
+// billed cost. Nothing in it depends on stored state, so a caller repeating
+// a request shape compiles it once and varies projectId and the window.
+struct AllocationPlan {
+    std::string projectId;
+    SkillSet requiredSkills;
+    std::size_t teamSize = 0;
+    std::chrono::system_clock::time_point startDate;
+    std::chrono::system_clock::time_point endDate;
+    double budgetCeiling = std::numeric_limits<double>::infinity();  // Infinite without a budget
+};
+
+// Resources are stored in a sharded slot map and addressed internally by
+// ResourceHandle; the UUID string is only mapped at the public API boundary.
+//
+// Thread safety: every method may be called concurrently. Resources and their
+// booking calendars are sharded by ID hash, each shard behind its own
+// reader-writer lock. A resource shard lock may be held while calling into
+// the project or talent manager, never the other way round.
+//
+// Read views: forEach* and with* run the visitor while holding the shard's
+// read lock, so the visitor must not call back into mutating methods of the
+// allocator. find* returns a raw pointer (nullptr when missing) that stays
+// valid only until the next mutating call; it is not protected against
+// concurrent writers and is meant for single-threaded use.
+//
+// Teams: an allocation records its talents on the project's team and the
+// project on each talent's completedProjects. The allocator does not link
+// the two managers; ProjectManager::attachTalentManager opts in to keeping
+// every later team and talent change in step on both sides, which also
+// changes what their public mutators accept and do.
 class ResourceAllocator {
 public:
-    ResourceAllocator(ProjectManager& projectManager, TalentManager& talentManager);
+    // Resources, their booking calendars and the type index allocate from
+    // `resource`; see ProjectManager for the requirements on it.
+    ResourceAllocator(ProjectManager& projectManager, TalentManager& talentManager,
+                      std::size_t shardCount = 1,
+                      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~ResourceAllocator();
 
     // Resource management
@@ -44,35 +100,207 @@ public:
     bool updateResource(const std::string& resourceId, const Resource& resource);
     bool removeResource(const std::string& resourceId);
     Resource getResource(const std::string& resourceId);
+    const Resource* findResource(const std::string& resourceId) const;
+    bool withResource(const std::string& resourceId,
+                      const std::function<void(const Resource&)>& visitor) const;
+    std::size_t resourceCount() const;
+    ResourceHandle findResourceHandle(const std::string& resourceId) const;
+    const Resource* findResource(ResourceHandle handle) const;
 
-    // Resource allocation
+    // Persistence. Once a log is attached every mutation is recorded in it
+    // and returns only after its record is durable, or throws
+    // std::runtime_error if the log failed; attach before concurrent use.
+    // The log must be the one attached to the project and talent managers.
+    // restoreResource inserts or replaces a resource and its bookings under
+    // its own ID and is meant for recovery.
+    void attachLog(MutationLog* log);
+    // Every mutation, restores included, publishes a RESOURCE event to the
+    // attached feed; attach before concurrent use
+    void attachChangeFeed(ChangeFeed* feed);
+    bool restoreResource(const Resource& resource, const std::vector<Booking>& bookings);
+    void forEachResource(const std::function<bool(const Resource&, const BookingCalendar&)>& visitor) const;
+
+    // Resource allocation. allocateResources is an optimistic transaction:
+    // candidates are read without holding locks, then revalidated against
+    // their versions and committed all-or-nothing, retrying on conflict. A
+    // committed allocation records the project on each talent and the talents
+    // on the project's team. The team is the requiredTeamSize best-ranked
+    // matching talents, ranked by hourlyRate discounted for experienceLevel
+    // and raised for the projects already on the talent. A positive budget
+    // caps the team's billed cost (rate x window hours); when the best-ranked
+    // team breaks it, the cheapest team is taken if that fits.
     AllocationResult allocateResources(const AllocationRequest& request);
+    // The same for a request already compiled with compileAllocation
+    AllocationResult allocatePlan(const AllocationPlan& plan);
+    // Skills may be given by name ("WEB_DESIGN") or number ("2"). Returns
+    // nullopt, with the reason in *error, for an unknown skill, a negative
+    // team size or an empty window.
+    static std::optional<AllocationPlan> compileAllocation(const AllocationRequest& request,
+                                                           std::string* error = nullptr);
+    // Staffs a whole batch as one min-cost assignment instead of request by
+    // request. Talents are ranked by hourlyRate discounted for experienceLevel;
+    // a positive budget caps the billed cost (rate x window hours) of each
+    // request's team, and within a batch each talent joins at most one team.
+    // A request the solve leaves unstaffed is then allocated on its own, as
+    // by allocateResources, and may share talents with the batch's teams.
+    // Results are returned in request order.
+    std::vector<AllocationResult> allocateResourcesBatch(const std::vector<AllocationRequest>& requests);
+    // Releases the project's bookings and frees the resources it occupies,
+    // visiting only the project's resources; its team is left as it is
     bool deallocateResources(const std::string& projectId);
     
     // Resource availability
     bool updateResourceAvailability(const std::string& resourceId, bool isAvailable);
     std::vector<Resource> getAvailableResources();
+    void forEachAvailableResource(const std::function<bool(const Resource&)>& visitor) const;
+
+    // Booking calendar
+    bool isResourceFree(const std::string& resourceId,
+                        const std::chrono::system_clock::time_point& startDate,
+                        const std::chrono::system_clock::time_point& endDate) const;
+    std::vector<std::string> findFreeResources(const std::string& type,
+                                               const std::chrono::system_clock::time_point& startDate,
+                                               const std::chrono::system_clock::time_point& endDate) const;
+    const BookingCalendar* findBookingCalendar(const std::string& resourceId) const;
     
-    // Resource tracking
+    // Resource tracking. The resources of a project are found through a
+    // project-to-resource index, in time proportional to their number.
     std::vector<Resource> getResourcesByProject(const std::string& projectId);
     std::vector<Resource> getResourcesByType(const std::string& type);
+    void forEachResourceOfProject(const std::string& projectId,
+                                  const std::function<bool(const Resource&)>& visitor) const;
+    void forEachResourceOfType(const std::string& type,
+                               const std::function<bool(const Resource&)>& visitor) const;
     
-    // Resource optimization
-    void optimizeResourceAllocation();
+    // Resource optimization. A pass only looks at resources that changed, or
+    // whose booking is due to run out, since the previous pass. It releases
+    // allocations to projects that are gone, finished or past their booking,
+    // and hands the project of an overutilized resource to an idle resource
+    // of the same type that can take it without becoming overutilized. Shard locks
+    // are only try-locked, so a contended resource is left for the next pass
+    // instead of stalling foreground calls. Returns the number of resources
+    // changed.
+    std::size_t optimizeResourceAllocation();
+    std::size_t optimizeResourceAllocation(std::chrono::microseconds timeBudget);
+    // Runs a pass every `interval`, each bounded by `timeBudget`, on a
+    // background thread until stopBackgroundOptimizer or destruction
+    bool startBackgroundOptimizer(std::chrono::milliseconds interval,
+                                  std::chrono::microseconds timeBudget);
+    void stopBackgroundOptimizer();
+
+    // Utilization is the share of time a resource is booked. Every resource
+    // keeps its booked time in daily buckets, updated as it is booked and
+    // released, and is filed under a band by its utilization over the seven
+    // days starting today: under 30% is underutilized, over 90% overutilized.
+    // The band queries only visit the resources in the band.
     std::vector<std::string> getUnderutilizedResources();
     std::vector<std::string> getOverutilizedResources();
+    // Utilization over [from, to), past or future. Time a resource served
+    // stays counted after its booking is released, but only for as long as
+    // the allocator runs; a restore only knows the bookings it is given.
+    double getResourceUtilization(const std::string& resourceId,
+                                  const std::chrono::system_clock::time_point& from,
+                                  const std::chrono::system_clock::time_point& to) const;
 
 private:
     ProjectManager& projectManager_;
     TalentManager& talentManager_;
-    std::map<std::string, Resource> resources_;
+
+    enum class UtilizationBand {
+        UNDER,
+        NORMAL,
+        OVER
+    };
+    static constexpr std::size_t kUtilizationBandCount = 3;
+
+    struct ResourceEntry {
+        Resource resource;
+        BookingCalendar calendar;
+        std::uint64_t version = 0;  // Bumped on every change, for optimistic commits
+        UtilizationHistory history;
+        std::chrono::system_clock::duration windowBooked{0};  // Booked within the shard's utilization window
+        UtilizationBand band = UtilizationBand::UNDER;
+    };
+
+    struct ResourceCandidate {
+        ResourceHandle handle;
+        std::uint64_t version;
+    };
+
+    struct ShardIndex {
+        explicit ShardIndex(std::pmr::memory_resource* resource)
+            : byType(resource),
+              byBand(makeContainerArray<ResourceSet, kUtilizationBandCount>(resource)) {}
+
+        using ResourceSet = std::pmr::unordered_set<ResourceHandle, HandleHash>;
+        std::pmr::unordered_map<Symbol, std::pmr::set<ResourceHandle>, SymbolHash> byType;
+        std::array<ResourceSet, kUtilizationBandCount> byBand;
+        // First day of the window the bands were computed for; moved forward
+        // lazily, the first time the shard is touched on a new day
+        UtilizationHistory::Bucket windowStart = 0;
+    };
+
+    using Store = ShardedStore<ResourceEntry, ResourceTag, ShardIndex>;
+    Store resources_;
+    MutationLog* log_ = nullptr;
+    ChangeFeed* feed_ = nullptr;
+    // Resources holding each project, as current project or by booking;
+    // updated under the resource's shard lock
+    AssignmentIndex<ResourceHandle, HandleHash> projectResources_;
+
+    enum class RebalanceOutcome {
+        SETTLED,
+        CHANGED,
+        CONTENDED,   // A shard lock was busy; retry next pass
+        UNRESOLVED   // Still overutilized with no idle resource to take over
+    };
+
+    // Optimizer work queue, guarded by optimizerMutex_. The mutex is a leaf:
+    // it may be taken under a resource shard lock, nothing is called under it.
+    using ScheduledCheck = std::pair<std::chrono::system_clock::time_point, ResourceHandle>;
+    std::mutex optimizerMutex_;
+    std::unordered_set<ResourceHandle, HandleHash> dirtyResources_;
+    std::priority_queue<ScheduledCheck, std::vector<ScheduledCheck>, std::greater<ScheduledCheck>> scheduledChecks_;
+
+    // Background pass thread; start/stop are serialized by optimizerControlMutex_
+    std::mutex optimizerControlMutex_;
+    std::thread optimizerThread_;
+    std::mutex optimizerWakeupMutex_;
+    std::condition_variable optimizerWakeup_;
+    bool optimizerStopping_ = false;
     
     // Helper methods
-    bool isResourceAvailable(const Resource& resource, 
+    bool isResourceAvailable(const ResourceEntry& entry,
                            const std::chrono::system_clock::time_point& startDate,
-                           const std::chrono::system_clock::time_point& endDate);
-    std::vector<std::string> findMatchingTalents(const std::vector<std::string>& requiredSkills);
-    double calculateResourceUtilization(const std::string& resourceId);
+                           const std::chrono::system_clock::time_point& endDate) const;
+    static void unindexResourceType(ShardIndex& index, ResourceHandle handle, Symbol type);
+    static bool holdsProject(const ResourceEntry& entry, const std::string& projectId);
+    void linkProjects(ResourceHandle handle, const ResourceEntry& entry);
+    void unlinkProjects(ResourceHandle handle, const ResourceEntry& entry);
+    void syncProjectLink(ResourceHandle handle, const ResourceEntry& entry, const std::string& projectId);
+    template <typename Visitor>
+    void forEachEntry(Visitor&& visitor) const;
+    ResourceEntry makeEntry(const Resource& resource) const;
+    bool checkPlan(const AllocationPlan& plan, AllocationResult& result) const;
+    AllocationResult executePlan(const AllocationPlan& plan);
+    bool chooseTeam(const AllocationPlan& plan, std::vector<TalentCandidate>& team, AllocationResult& result) const;
+    std::vector<ResourceCandidate> findResourceCandidates(const AllocationPlan& plan) const;
+    bool commitAllocation(const AllocationPlan& plan,
+                          const std::vector<TalentCandidate>& talents,
+                          const std::vector<ResourceCandidate>& resources,
+                          AllocationResult& result);
+    void updateUtilization(Store::Shard& shard, ResourceHandle handle, ResourceEntry& entry);
+    void refreshUtilization(Store::Shard& shard, ResourceHandle handle, ResourceEntry& entry);
+    void slideUtilizationWindow(Store::Shard& shard, UtilizationHistory::Bucket today);
+    std::vector<std::string> resourcesInBand(UtilizationBand band);
+    std::size_t releaseProjectBookings(Store::Shard& shard, ResourceHandle handle, ResourceEntry& entry,
+                                       const std::string& projectId);
+    void markResourceChanged(ResourceHandle handle);
+    void logResource(const ResourceEntry& entry);
+    RebalanceOutcome rebalanceResource(ResourceHandle handle);
+    bool findIdleResource(Symbol type, const Booking& booking, std::chrono::system_clock::duration load,
+                          ResourceHandle exclude, ResourceCandidate& idle) const;
+    RebalanceOutcome handOver(ResourceCandidate source, ResourceCandidate target, const Booking& booking);
 };
 
 } // namespace imagined 
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Handle.hpp"
+#include "SlotMap.hpp"
+
+namespace imagined {
+
+// Entity store split into independently locked shards. An entity lives in the
+// shard picked by hashing its external ID, and its handle carries the shard
+// number in the low bits of the index, so both ID and handle lookups go
+// straight to one shard. Each shard also owns an `Index` value where managers
+// keep their per-shard secondary indexes, updated under the same lock as the
+// entities themselves.
+//
+// Slots, the ID map and the shard indexes all allocate from the memory
+// resource given at construction, so an `Index` must be constructible from a
+// std::pmr::memory_resource* and pass it on to its containers.
+//
+// The store does no locking of its own: callers take Shard::mutex (shared for
+// reads, exclusive for writes) around every access to a shard. When several
+// shards must be held at once they are always locked in ascending order.
+template <typename T, typename Tag, typename Index>
+class ShardedStore {
+public:
+    using HandleType = Handle<Tag>;
+
+    class Shard {
+    public:
+        explicit Shard(std::pmr::memory_resource* resource)
+            : index(resource), slots_(resource), handles_(resource) {}
+
+        mutable std::shared_mutex mutex;
+        Index index;
+
+        HandleType insert(const std::string& id, T value) {
+            HandleType handle = toGlobal(slots_.insert(std::move(value)));
+            handles_.emplace(id, handle);
+            return handle;
+        }
+
+        bool erase(const std::string& id) {
+            auto it = handles_.find(id);
+            if (it == handles_.end()) {
+                return false;
+            }
+            slots_.erase(toLocal(it->second));
+            handles_.erase(it);
+            return true;
+        }
+
+        HandleType findHandle(const std::string& id) const {
+            auto it = handles_.find(id);
+            return it == handles_.end() ? HandleType{} : it->second;
+        }
+
+        T* find(HandleType handle) {
+            return belongs(handle) ? slots_.find(toLocal(handle)) : nullptr;
+        }
+        const T* find(HandleType handle) const {
+            return belongs(handle) ? slots_.find(toLocal(handle)) : nullptr;
+        }
+        T* find(const std::string& id) { return find(findHandle(id)); }
+        const T* find(const std::string& id) const { return find(findHandle(id)); }
+
+        // Local slot index space, for per-shard packed columns
+        std::size_t slotCount() const { return slots_.slotCount(); }
+        const T* atLocalIndex(std::uint32_t index) const { return slots_.atIndex(index); }
+        std::uint32_t localIndex(HandleType handle) const { return handle.index >> bits_; }
+        HandleType handleAtLocalIndex(std::uint32_t index) const {
+            return toGlobal(slots_.handleAt(index));
+        }
+
+        std::size_t size() const { return slots_.size(); }
+
+        template <typename Visitor>
+        void forEach(Visitor&& visitor) const {
+            slots_.forEach([&](HandleType local, const T& value) {
+                return visitor(toGlobal(local), value);
+            });
+        }
+
+        template <typename Visitor>
+        void forEachMutable(Visitor&& visitor) {
+            slots_.forEachMutable([&](HandleType local, T& value) {
+                return visitor(toGlobal(local), value);
+            });
+        }
+
+    private:
+        friend class ShardedStore;
+
+        std::uint32_t number_ = 0;
+        std::uint32_t bits_ = 0;
+        SlotMap<T, Tag> slots_;
+        std::pmr::unordered_map<std::string, HandleType> handles_;
+
+        bool belongs(HandleType handle) const {
+            return handle.valid() && (handle.index & ((1u << bits_) - 1)) == number_;
+        }
+        HandleType toGlobal(HandleType local) const {
+            return HandleType{(local.index << bits_) | number_, local.generation};
+        }
+        HandleType toLocal(HandleType global) const {
+            return HandleType{global.index >> bits_, global.generation};
+        }
+    };
+
+    // The shard count is rounded up to a power of two
+    explicit ShardedStore(std::size_t shardCount,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : resource_(resource) {
+        while ((std::size_t(1) << bits_) < shardCount && bits_ < 16) {
+            ++bits_;
+        }
+        shards_.reserve(std::size_t(1) << bits_);
+        for (std::uint32_t i = 0; i < (1u << bits_); ++i) {
+            shards_.push_back(std::make_unique<Shard>(resource));
+            shards_.back()->number_ = i;
+            shards_.back()->bits_ = bits_;
+        }
+    }
+
+    std::size_t shardCount() const { return shards_.size(); }
+    std::pmr::memory_resource* resource() const { return resource_; }
+
+    Shard& shard(std::size_t i) { return *shards_[i]; }
+    const Shard& shard(std::size_t i) const { return *shards_[i]; }
+
+    Shard& shardFor(const std::string& id) { return *shards_[shardNumberFor(id)]; }
+    const Shard& shardFor(const std::string& id) const { return *shards_[shardNumberFor(id)]; }
+
+    Shard& shardOf(HandleType handle) { return *shards_[shardNumberOf(handle)]; }
+    const Shard& shardOf(HandleType handle) const { return *shards_[shardNumberOf(handle)]; }
+    std::size_t shardNumberOf(HandleType handle) const { return handle.index & mask(); }
+
+    // Total entity count, taking each shard's read lock in turn
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const auto& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard->mutex);
+            total += shard->size();
+        }
+        return total;
+    }
+
+    // Locks every shard for reading, in ascending order
+    std::vector<std::shared_lock<std::shared_mutex>> lockAllShared() const {
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(shards_.size());
+        for (const auto& shard : shards_) {
+            locks.emplace_back(shard->mutex);
+        }
+        return locks;
+    }
+
+    // Locks the given shards for writing, in ascending order; duplicates are ignored
+    std::vector<std::unique_lock<std::shared_mutex>> lockExclusive(std::vector<std::size_t> shardNumbers) {
+        std::sort(shardNumbers.begin(), shardNumbers.end());
+        shardNumbers.erase(std::unique(shardNumbers.begin(), shardNumbers.end()), shardNumbers.end());
+
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(shardNumbers.size());
+        for (std::size_t number : shardNumbers) {
+            locks.emplace_back(shards_[number]->mutex);
+        }
+        return locks;
+    }
+
+private:
+    std::pmr::memory_resource* resource_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::uint32_t bits_ = 0;
+
+    std::uint32_t mask() const { return (1u << bits_) - 1; }
+    std::size_t shardNumberFor(const std::string& id) const {
+        return std::hash<std::string>()(id) & mask();
+    }
+};
+
+template <typename Container, std::size_t... I>
+std::array<Container, sizeof...(I)> makeContainerArray(std::pmr::memory_resource* resource,
+                                                       std::index_sequence<I...>) {
+    return {{((void)I, Container(resource))...}};
+}
+
+// Array of allocator-aware containers that all draw from `resource`, for
+// per-category buckets inside a shard index
+template <typename Container, std::size_t N>
+std::array<Container, N> makeContainerArray(std::pmr::memory_resource* resource) {
+    return makeContainerArray<Container>(resource, std::make_index_sequence<N>{});
+}
+
+} // namespace imagined
@@ -0,0 +1,54 @@
+#include "SkillMatch.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace imagined {
+
+namespace {
+
+// Each matching 16-bit lane sets two adjacent bits in a byte movemask;
+// keep the low bit of each pair and turn it back into a lane index.
+inline void appendLaneMatches(std::uint32_t byteMask, std::size_t base,
+                              std::vector<std::size_t>& out) {
+    byteMask &= 0x55555555u;
+    while (byteMask != 0) {
+        unsigned bit = static_cast<unsigned>(__builtin_ctz(byteMask));
+        out.push_back(base + bit / 2);
+        byteMask &= byteMask - 1;
+    }
+}
+
+} // namespace
+
+void matchSkillKeys(const std::uint16_t* keys, std::size_t count,
+                    std::uint16_t required, std::vector<std::size_t>& out) {
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i wanted = _mm256_set1_epi16(static_cast<short>(required));
+    for (; i + 16 <= count; i += 16) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+        __m256i hit = _mm256_cmpeq_epi16(_mm256_and_si256(block, wanted), wanted);
+        appendLaneMatches(static_cast<std::uint32_t>(_mm256_movemask_epi8(hit)), i, out);
+    }
+#elif defined(__SSE2__)
+    const __m128i wanted = _mm_set1_epi16(static_cast<short>(required));
+    for (; i + 8 <= count; i += 8) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        __m128i hit = _mm_cmpeq_epi16(_mm_and_si128(block, wanted), wanted);
+        appendLaneMatches(static_cast<std::uint32_t>(_mm_movemask_epi8(hit)), i, out);
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if ((keys[i] & required) == required) {
+            out.push_back(i);
+        }
+    }
+}
+
+} // namespace imagined
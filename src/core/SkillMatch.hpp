@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace imagined {
+
+// Appends to `out` the index of every key that has all bits of `required` set.
+// Uses SSE2/AVX2 when available and falls back to a scalar loop otherwise.
+void matchSkillKeys(const std::uint16_t* keys, std::size_t count,
+                    std::uint16_t required, std::vector<std::size_t>& out);
+
+} // namespace imagined
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "Handle.hpp"
+
+namespace imagined {
+
+// Dense slot storage addressed by generational handles. Lookup is a bounds
+// check plus a generation compare; freed slots are recycled LIFO and bump
+// their generation so stale handles stop resolving. Element pointers are
+// invalidated by insert (the slot vector may grow). The slot and free lists
+// draw from the given memory resource.
+template <typename T, typename Tag>
+class SlotMap {
+public:
+    using HandleType = Handle<Tag>;
+
+    explicit SlotMap(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : slots_(resource), freeSlots_(resource) {}
+
+    HandleType insert(T value) {
+        std::uint32_t index;
+        if (!freeSlots_.empty()) {
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        Slot& slot = slots_[index];
+        slot.value.emplace(std::move(value));
+        ++size_;
+        return HandleType{index, slot.generation};
+    }
+
+    bool erase(HandleType handle) {
+        if (find(handle) == nullptr) {
+            return false;
+        }
+        Slot& slot = slots_[handle.index];
+        slot.value.reset();
+        ++slot.generation;
+        freeSlots_.push_back(handle.index);
+        --size_;
+        return true;
+    }
+
+    T* find(HandleType handle) {
+        if (handle.index >= slots_.size()) {
+            return nullptr;
+        }
+        Slot& slot = slots_[handle.index];
+        return slot.value && slot.generation == handle.generation ? &*slot.value : nullptr;
+    }
+
+    const T* find(HandleType handle) const {
+        return const_cast<SlotMap*>(this)->find(handle);
+    }
+
+    // Raw slot access for scans over the index space
+    T* atIndex(std::uint32_t index) {
+        return index < slots_.size() && slots_[index].value ? &*slots_[index].value : nullptr;
+    }
+    const T* atIndex(std::uint32_t index) const {
+        return const_cast<SlotMap*>(this)->atIndex(index);
+    }
+    HandleType handleAt(std::uint32_t index) const {
+        return HandleType{index, slots_[index].generation};
+    }
+
+    template <typename Visitor>
+    void forEach(Visitor&& visitor) const {
+        for (std::uint32_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].value && !visitor(HandleType{i, slots_[i].generation}, *slots_[i].value)) {
+                break;
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEachMutable(Visitor&& visitor) {
+        for (std::uint32_t i = 0; i < slots_.size(); ++i) {
+            if (slots_[i].value && !visitor(HandleType{i, slots_[i].generation}, *slots_[i].value)) {
+                break;
+            }
+        }
+    }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t slotCount() const { return slots_.size(); }
+
+    void reserve(std::size_t count) { slots_.reserve(count); }
+
+private:
+    struct Slot {
+        std::optional<T> value;
+        std::uint32_t generation = 0;
+    };
+
+    std::pmr::vector<Slot> slots_;
+    std::pmr::vector<std::uint32_t> freeSlots_;
+    std::size_t size_ = 0;
+};
+
+} // namespace imagined
@@ -0,0 +1,130 @@
+#include "Symbol.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace imagined {
+
+namespace {
+
+constexpr std::size_t kChunkBits = 12;
+constexpr std::size_t kChunkSize = std::size_t(1) << kChunkBits;
+constexpr std::size_t kMaxChunks = 4096;
+constexpr std::size_t kLookupStripes = 16;
+
+// Texts are stored in fixed-size chunks that are never moved or freed, so
+// reading the text of an ID takes no lock: whoever holds an ID got it after
+// its text was written. The text-to-ID maps are split into stripes, each
+// behind its own reader-writer lock; lookups of known texts, the common case,
+// only take a stripe's read lock.
+class SymbolTable {
+public:
+    SymbolTable() {
+        Symbol::Id empty = store("");
+        stripeFor("").ids.emplace(text(empty), empty);
+    }
+
+    Symbol::Id intern(std::string_view value) {
+        Stripe& stripe = stripeFor(value);
+        {
+            std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+            auto it = stripe.ids.find(value);
+            if (it != stripe.ids.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.ids.find(value);
+        if (it != stripe.ids.end()) {
+            return it->second;
+        }
+        Symbol::Id id = store(value);
+        // Keyed by a view of the stored copy, which never moves
+        stripe.ids.emplace(text(id), id);
+        return id;
+    }
+
+    std::optional<Symbol::Id> find(std::string_view value) {
+        Stripe& stripe = stripeFor(value);
+        std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+        auto it = stripe.ids.find(value);
+        if (it == stripe.ids.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    const std::string& text(Symbol::Id id) const {
+        return (*chunks_[id >> kChunkBits].load(std::memory_order_acquire))[id & (kChunkSize - 1)];
+    }
+
+    std::size_t size() const { return count_.load(std::memory_order_acquire); }
+
+private:
+    using Chunk = std::array<std::string, kChunkSize>;
+
+    struct Stripe {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, Symbol::Id> ids;
+    };
+
+    std::array<Stripe, kLookupStripes> stripes_;
+    std::mutex storeMutex_;
+    std::array<std::atomic<Chunk*>, kMaxChunks> chunks_{};
+    std::atomic<std::size_t> count_{0};
+
+    Stripe& stripeFor(std::string_view value) {
+        return stripes_[std::hash<std::string_view>()(value) % kLookupStripes];
+    }
+
+    Symbol::Id store(std::string_view value) {
+        std::lock_guard<std::mutex> lock(storeMutex_);
+        std::size_t id = count_.load(std::memory_order_relaxed);
+        if (id >= kChunkSize * kMaxChunks) {
+            throw std::runtime_error("Symbol table full");
+        }
+        auto& slot = chunks_[id >> kChunkBits];
+        Chunk* chunk = slot.load(std::memory_order_relaxed);
+        if (chunk == nullptr) {
+            chunk = new Chunk();
+            slot.store(chunk, std::memory_order_release);
+        }
+        (*chunk)[id & (kChunkSize - 1)].assign(value.data(), value.size());
+        count_.store(id + 1, std::memory_order_release);
+        return static_cast<Symbol::Id>(id);
+    }
+};
+
+// Leaked so symbols stay readable during static destruction
+SymbolTable& table() {
+    static SymbolTable* instance = new SymbolTable();
+    return *instance;
+}
+
+} // namespace
+
+Symbol::Symbol(std::string_view text) : id_(text.empty() ? 0 : table().intern(text)) {}
+
+std::optional<Symbol> Symbol::find(std::string_view text) {
+    if (text.empty()) {
+        return Symbol();
+    }
+    std::optional<Id> id = table().find(text);
+    if (!id) {
+        return std::nullopt;
+    }
+    return Symbol(*id, 0);
+}
+
+std::size_t Symbol::tableSize() {
+    return table().size();
+}
+
+const std::string& Symbol::str() const {
+    return table().text(id_);
+}
+
+} // namespace imagined
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace imagined {
+
+// Interned string for low-cardinality fields such as timezones, languages,
+// client IDs and resource types. A Symbol is a 32-bit ID into a process-wide,
+// thread-safe table, so copies are free and equality is an integer compare;
+// the text is stored once and lives until the process exits. The default
+// Symbol is the empty string.
+//
+// Symbol converts implicitly from and to std::string, so it can stand in for
+// a string field: assigning text interns it, reading it back yields a
+// reference to the table's copy.
+class Symbol {
+public:
+    using Id = std::uint32_t;
+
+    constexpr Symbol() = default;
+    Symbol(std::string_view text);
+    Symbol(const std::string& text) : Symbol(std::string_view(text)) {}
+    Symbol(const char* text) : Symbol(std::string_view(text)) {}
+
+    // The symbol of `text` if it has been interned, without interning it;
+    // lets a query on an unseen value answer "no match" instead of growing
+    // the table
+    static std::optional<Symbol> find(std::string_view text);
+    // Number of distinct symbols interned so far, the empty one included
+    static std::size_t tableSize();
+
+    constexpr Id id() const { return id_; }
+    const std::string& str() const;
+    operator const std::string&() const { return str(); }
+    const char* c_str() const { return str().c_str(); }
+    std::size_t size() const { return str().size(); }
+    constexpr bool empty() const { return id_ == 0; }
+
+    // Orders by ID, which is interning order rather than text order
+    friend constexpr bool operator==(Symbol a, Symbol b) { return a.id_ == b.id_; }
+    friend constexpr bool operator!=(Symbol a, Symbol b) { return a.id_ != b.id_; }
+    friend constexpr bool operator<(Symbol a, Symbol b) { return a.id_ < b.id_; }
+
+    friend bool operator==(Symbol a, std::string_view b) { return a.str() == b; }
+    friend bool operator==(std::string_view a, Symbol b) { return a == b.str(); }
+    friend bool operator==(Symbol a, const std::string& b) { return a.str() == b; }
+    friend bool operator==(const std::string& a, Symbol b) { return a == b.str(); }
+    friend bool operator==(Symbol a, const char* b) { return a.str() == b; }
+    friend bool operator==(const char* a, Symbol b) { return a == b.str(); }
+    friend bool operator!=(Symbol a, std::string_view b) { return !(a == b); }
+    friend bool operator!=(std::string_view a, Symbol b) { return !(a == b); }
+    friend bool operator!=(Symbol a, const std::string& b) { return !(a == b); }
+    friend bool operator!=(const std::string& a, Symbol b) { return !(a == b); }
+    friend bool operator!=(Symbol a, const char* b) { return !(a == b); }
+    friend bool operator!=(const char* a, Symbol b) { return !(a == b); }
+
+private:
+    constexpr explicit Symbol(Id id, int) : id_(id) {}
+
+    Id id_ = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& out, Symbol symbol) {
+    return out << symbol.str();
+}
+
+struct SymbolHash {
+    std::size_t operator()(Symbol symbol) const { return std::hash<Symbol::Id>()(symbol.id()); }
+};
+
+} // namespace imagined
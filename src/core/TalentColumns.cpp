@@ -0,0 +1,204 @@
+#include "TalentColumns.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace imagined {
+
+namespace {
+
+constexpr std::uint8_t kAnyLevel = 0xFF;
+constexpr Symbol::Id kAnySymbol = 0xFFFFFFFF;  // Above any ID the table hands out
+
+struct ColumnRange {
+    const std::uint16_t* keys;
+    const double* rates;
+    const std::uint8_t* levels;
+    const Symbol::Id* timezones;
+    const Symbol::Id* languages;
+    std::size_t count;
+};
+
+struct RowFilter {
+    std::uint16_t required;
+    std::uint8_t level;
+    double minRate;
+    double maxRate;
+    Symbol::Id timezone;
+    Symbol::Id language;
+};
+
+inline bool rowMatches(const ColumnRange& columns, std::size_t i, const RowFilter& filter) {
+    return (columns.keys[i] & filter.required) == filter.required &&
+           (filter.level == kAnyLevel || columns.levels[i] == filter.level) &&
+           columns.rates[i] >= filter.minRate && columns.rates[i] <= filter.maxRate &&
+           (filter.timezone == kAnySymbol || columns.timezones[i] == filter.timezone) &&
+           (filter.language == kAnySymbol || columns.languages[i] == filter.language);
+}
+
+#if defined(__SSE2__) || defined(__AVX2__)
+// One bit per row for the 16 IDs from `ids` equal to `wanted`
+inline std::uint32_t symbolHits(const Symbol::Id* ids, __m128i wanted) {
+    __m128i first = _mm_packs_epi32(
+        _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ids)), wanted),
+        _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + 4)), wanted));
+    __m128i second = _mm_packs_epi32(
+        _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + 8)), wanted),
+        _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + 12)), wanted));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(first, second)));
+}
+#endif
+
+// Filters 16 rows per step: key, level and symbol compares yield one bit per
+// row, the rate compares are folded into the same bit mask, and the bit mask
+// then drives a masked rate sum and one popcount per level.
+void aggregateRange(const ColumnRange& columns, const RowFilter& filter, TalentAggregate& out) {
+    std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(__AVX2__)
+    const __m128i wantedKey = _mm_set1_epi16(static_cast<short>(filter.required));
+    const __m128i wantedLevel = _mm_set1_epi8(static_cast<char>(filter.level));
+    const __m128i wantedTimezone = _mm_set1_epi32(static_cast<int>(filter.timezone));
+    const __m128i wantedLanguage = _mm_set1_epi32(static_cast<int>(filter.language));
+    __m128i levelValues[kExperienceLevelCount];
+    for (std::size_t l = 0; l < kExperienceLevelCount; ++l) {
+        levelValues[l] = _mm_set1_epi8(static_cast<char>(l));
+    }
+#if defined(__AVX2__)
+    const __m256d low = _mm256_set1_pd(filter.minRate);
+    const __m256d high = _mm256_set1_pd(filter.maxRate);
+    __m256d sum = _mm256_setzero_pd();
+#else
+    const __m128d low = _mm_set1_pd(filter.minRate);
+    const __m128d high = _mm_set1_pd(filter.maxRate);
+    __m128d sum = _mm_setzero_pd();
+#endif
+
+    for (; i + 16 <= columns.count; i += 16) {
+        __m128i keysLow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.keys + i));
+        __m128i keysHigh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.keys + i + 8));
+        __m128i keyHits = _mm_packs_epi16(_mm_cmpeq_epi16(_mm_and_si128(keysLow, wantedKey), wantedKey),
+                                          _mm_cmpeq_epi16(_mm_and_si128(keysHigh, wantedKey), wantedKey));
+        auto hits = static_cast<std::uint32_t>(_mm_movemask_epi8(keyHits));
+        if (hits == 0) {
+            continue;
+        }
+        __m128i levels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns.levels + i));
+        if (filter.level != kAnyLevel) {
+            hits &= static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(levels, wantedLevel)));
+        }
+        if (filter.timezone != kAnySymbol) {
+            hits &= symbolHits(columns.timezones + i, wantedTimezone);
+        }
+        if (filter.language != kAnySymbol) {
+            hits &= symbolHits(columns.languages + i, wantedLanguage);
+        }
+        if (hits == 0) {
+            continue;
+        }
+
+        std::uint32_t inRange = 0;
+#if defined(__AVX2__)
+        for (std::size_t lane = 0; lane < 16; lane += 4) {
+            __m256d rates = _mm256_loadu_pd(columns.rates + i + lane);
+            __m256d ok = _mm256_and_pd(_mm256_cmp_pd(rates, low, _CMP_GE_OQ), _mm256_cmp_pd(rates, high, _CMP_LE_OQ));
+            inRange |= static_cast<std::uint32_t>(_mm256_movemask_pd(ok)) << lane;
+        }
+#else
+        for (std::size_t lane = 0; lane < 16; lane += 2) {
+            __m128d rates = _mm_loadu_pd(columns.rates + i + lane);
+            __m128d ok = _mm_and_pd(_mm_cmpge_pd(rates, low), _mm_cmple_pd(rates, high));
+            inRange |= static_cast<std::uint32_t>(_mm_movemask_pd(ok)) << lane;
+        }
+#endif
+        hits &= inRange;
+        if (hits == 0) {
+            continue;
+        }
+
+        out.count += static_cast<std::size_t>(__builtin_popcount(hits));
+        for (std::size_t l = 0; l < kExperienceLevelCount; ++l) {
+            auto atLevel = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(levels, levelValues[l])));
+            out.byLevel[l] += static_cast<std::size_t>(__builtin_popcount(hits & atLevel));
+        }
+#if defined(__AVX2__)
+        for (std::size_t lane = 0; lane < 16; lane += 4) {
+            std::uint32_t bits = (hits >> lane) & 0xF;
+            if (bits == 0) {
+                continue;
+            }
+            __m256i laneMask = _mm256_set_epi64x(-static_cast<long long>((bits >> 3) & 1),
+                                                 -static_cast<long long>((bits >> 2) & 1),
+                                                 -static_cast<long long>((bits >> 1) & 1),
+                                                 -static_cast<long long>(bits & 1));
+            sum = _mm256_add_pd(sum, _mm256_and_pd(_mm256_loadu_pd(columns.rates + i + lane),
+                                                   _mm256_castsi256_pd(laneMask)));
+        }
+#else
+        for (std::size_t lane = 0; lane < 16; lane += 2) {
+            std::uint32_t bits = (hits >> lane) & 0x3;
+            if (bits == 0) {
+                continue;
+            }
+            __m128i laneMask = _mm_set_epi64x(-static_cast<long long>((bits >> 1) & 1),
+                                              -static_cast<long long>(bits & 1));
+            sum = _mm_add_pd(sum, _mm_and_pd(_mm_loadu_pd(columns.rates + i + lane), _mm_castsi128_pd(laneMask)));
+        }
+#endif
+    }
+
+#if defined(__AVX2__)
+    alignas(32) double partial[4];
+    _mm256_store_pd(partial, sum);
+    out.rateSum += partial[0] + partial[1] + partial[2] + partial[3];
+#else
+    alignas(16) double partial[2];
+    _mm_store_pd(partial, sum);
+    out.rateSum += partial[0] + partial[1];
+#endif
+#endif
+
+    for (; i < columns.count; ++i) {
+        if (rowMatches(columns, i, filter)) {
+            ++out.count;
+            out.rateSum += columns.rates[i];
+            ++out.byLevel[columns.levels[i]];
+        }
+    }
+}
+
+} // namespace
+
+TalentAggregate TalentColumns::aggregate(const TalentFilter& filter) const {
+    TalentAggregate result;
+    if (!(filter.minRate <= filter.maxRate)) {
+        return result;
+    }
+    RowFilter rows;
+    rows.required = static_cast<std::uint16_t>(filter.requiredSkills.mask() | kPresentBit |
+                                               (filter.availableOnly ? kAvailableBit : 0));
+    rows.level = filter.experienceLevel ? static_cast<std::uint8_t>(*filter.experienceLevel) : kAnyLevel;
+    rows.minRate = filter.minRate;
+    rows.maxRate = filter.maxRate;
+    rows.timezone = filter.timezone ? filter.timezone->id() : kAnySymbol;
+    rows.language = filter.preferredLanguage ? filter.preferredLanguage->id() : kAnySymbol;
+    for (const Segment& segment : segments_) {
+        ColumnRange columns{segment.keys.data(), segment.rates.data(), segment.levels.data(),
+                            segment.timezones.data(), segment.languages.data(), segment.keys.size()};
+        aggregateRange(columns, rows, result);
+    }
+    return result;
+}
+
+std::size_t TalentColumns::rowCount() const {
+    std::size_t rows = 0;
+    for (const Segment& segment : segments_) {
+        rows += segment.keys.size();
+    }
+    return rows;
+}
+
+} // namespace imagined
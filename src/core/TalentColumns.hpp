@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TalentManager.hpp"
+
+namespace imagined {
+
+struct TalentAggregate {
+    std::size_t count = 0;
+    double rateSum = 0.0;
+    std::array<std::size_t, kExperienceLevelCount> byLevel{};
+};
+
+// Structure-of-arrays snapshot of the talent attributes reporting scans read:
+// packed skill/availability keys, hourly rates, experience levels and the
+// timezone and language symbol IDs, one segment per talent shard, indexed by
+// local slot.
+//
+// A snapshot is filled and kept current by TalentManager::refreshColumns,
+// which only copies the slots changed since the previous refresh. Queries run
+// on the snapshot without taking any lock; a snapshot itself is not
+// synchronized and must not be refreshed while it is being queried.
+class TalentColumns {
+public:
+    static constexpr std::uint16_t kAvailableBit = 0x8000;
+    static constexpr std::uint16_t kPresentBit = 0x4000;  // Clear on free slots
+
+    TalentAggregate aggregate(const TalentFilter& filter) const;
+    std::size_t count(const TalentFilter& filter) const { return aggregate(filter).count; }
+    double sumRates(const TalentFilter& filter) const { return aggregate(filter).rateSum; }
+    std::array<std::size_t, kExperienceLevelCount> levelHistogram(const TalentFilter& filter) const {
+        return aggregate(filter).byLevel;
+    }
+    std::size_t rowCount() const;
+
+private:
+    friend class TalentManager;
+
+    struct Segment {
+        std::vector<std::uint16_t> keys;
+        std::vector<double> rates;
+        std::vector<std::uint8_t> levels;
+        std::vector<Symbol::Id> timezones;
+        std::vector<Symbol::Id> languages;
+        std::uint64_t logEpoch = 0;
+        std::size_t logPosition = 0;
+        bool built = false;
+    };
+
+    std::vector<Segment> segments_;
+};
+
+} // namespace imagined
@@ -1,174 +1,918 @@
 #include "TalentManager.hpp"
+#include "ProjectManager.hpp"
+#include "SkillMatch.hpp"
+#include "TalentColumns.hpp"
+#include "IdGenerator.hpp"
+#include "Metrics.hpp"
 #include <algorithm>
-#include <random>
-#include <sstream>
-#include <iomanip>
-#include <cctype>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
 
 namespace imagined {
 
-TalentManager::TalentManager() {}
+SkillType SkillSet::const_iterator::operator*() const {
+    return static_cast<SkillType>(__builtin_ctz(remaining_));
+}
+
+bool SkillSet::insert(SkillType skill) {
+    if (contains(skill)) {
+        return false;
+    }
+    mask_ |= bit(skill);
+    return true;
+}
+
+std::size_t SkillSet::erase(SkillType skill) {
+    if (!contains(skill)) {
+        return 0;
+    }
+    mask_ &= static_cast<Mask>(~bit(skill));
+    return 1;
+}
+
+std::size_t SkillSet::size() const {
+    return static_cast<std::size_t>(__builtin_popcount(mask_));
+}
+
+using ReadLock = std::shared_lock<std::shared_mutex>;
+using WriteLock = std::unique_lock<std::shared_mutex>;
+
+TalentManager::TalentManager(std::size_t shardCount, std::pmr::memory_resource* resource)
+    : talents_(shardCount, resource) {}
 
 TalentManager::~TalentManager() {}
 
 std::string TalentManager::addTalent(const Talent& talent) {
-    // Generate a unique talent ID
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-    const char* hex = "0123456789abcdef";
+    OperationScope timing(OperationId::ADD_TALENT);
+    DurableScope scope(log_);
+    Talent newTalent = talent;
     std::string uuid;
-    uuid.reserve(36);
-    
-    for (int i = 0; i < 36; i++) {
-        if (i == 8 || i == 13 || i == 18 || i == 23) {
-            uuid += '-';
-        } else {
-            uuid += hex[dis(gen)];
+    std::vector<std::string> projects;
+
+    // Generate a unique talent ID
+    while (true) {
+        uuid = generateUuid();
+        auto& shard = talents_.shardFor(uuid);
+        WriteLock lock(shard.mutex);
+        if (shard.findHandle(uuid).valid()) {
+            continue;
+        }
+
+        newTalent.id = uuid;
+        TalentHandle handle = shard.insert(uuid, std::move(newTalent));
+        Talent& stored = *shard.find(handle);
+        indexProjects(shard.index, shard.localIndex(handle), stored);
+        markTalentChanged(shard, handle, stored);
+        indexTalent(shard.index, shard.localIndex(handle), stored);
+        if (projectManager_ != nullptr) {
+            projects = stored.completedProjects;
         }
+        break;
+    }
+    // Each project is locked before the talent, so its team is brought in
+    // line afterwards
+    for (const auto& projectId : projects) {
+        projectManager_->reconcileLink(projectId, uuid);
     }
-    
-    Talent newTalent = talent;
-    newTalent.id = uuid;
-    talents_[uuid] = newTalent;
     return uuid;
 }
 
 bool TalentManager::updateTalent(const std::string& talentId, const Talent& talent) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::UPDATE_TALENT);
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* stored = shard.find(handle);
+    if (stored == nullptr) {
         return false;
     }
-    talents_[talentId] = talent;
+    bool reindex = stored->name != talent.name || stored->email != talent.email ||
+                   stored->hourlyRate != talent.hourlyRate || stored->experienceLevel != talent.experienceLevel;
+    if (reindex) {
+        unindexTalent(shard.index, shard.localIndex(handle), *stored);
+    }
+    std::uint32_t slot = shard.localIndex(handle);
+    auto previousProjects = shard.index.projects.extract(slot);
+    *stored = talent;
+    // The ID is the external key of the handle and cannot be changed by an update
+    stored->id = talentId;
+    indexProjects(shard.index, slot, *stored);
+    markTalentChanged(shard, handle, *stored);
+    if (reindex) {
+        indexTalent(shard.index, slot, *stored);
+    }
+
+    if (projectManager_ == nullptr) {
+        return true;
+    }
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    auto projects = shard.index.projects.find(slot);
+    diffLinks(previousProjects.empty() ? nullptr : &previousProjects.mapped(),
+              projects == shard.index.projects.end() ? nullptr : &projects->second, added, removed);
+    lock.unlock();
+    for (const auto& projectId : added) {
+        projectManager_->reconcileLink(projectId, talentId);
+    }
+    for (const auto& projectId : removed) {
+        projectManager_->reconcileLink(projectId, talentId);
+    }
     return true;
 }
 
 bool TalentManager::removeTalent(const std::string& talentId) {
-    return talents_.erase(talentId) > 0;
+    OperationScope timing(OperationId::REMOVE_TALENT);
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    while (true) {
+        WriteLock lock(shard.mutex);
+        TalentHandle handle = shard.findHandle(talentId);
+        const Talent* talent = shard.find(handle);
+        if (talent == nullptr) {
+            return false;
+        }
+        if (projectManager_ != nullptr && !talent->completedProjects.empty()) {
+            // Projects are locked before talents, so the talent leaves its
+            // projects with its lock released; only its own projects are
+            // visited, and one joined meanwhile is caught on the next round
+            std::vector<std::string> projects = talent->completedProjects;
+            lock.unlock();
+            for (const auto& projectId : projects) {
+                projectManager_->linkPair(projectId, talentId, false);
+            }
+            continue;
+        }
+        setMatchKey(shard.index, shard.localIndex(handle), 0);
+        unindexTalent(shard.index, shard.localIndex(handle), *talent);
+        shard.index.projects.erase(shard.localIndex(handle));
+        logSlotChange(shard, shard.localIndex(handle));
+        shard.erase(talentId);
+        if (log_ != nullptr) {
+            DurableScope::note(log_->eraseTalent(talentId));
+        }
+        if (feed_ != nullptr) {
+            feed_->publish(ChangeEntity::TALENT, ChangeType::ERASE, talentId);
+        }
+        return true;
+    }
 }
 
 Talent TalentManager::getTalent(const std::string& talentId) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::GET_TALENT);
+    auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    const Talent* talent = shard.find(talentId);
+    if (talent == nullptr) {
         throw std::runtime_error("Talent not found");
     }
-    return talents_[talentId];
+    return *talent;
+}
+
+const Talent* TalentManager::findTalent(const std::string& talentId) const {
+    OperationScope timing(OperationId::FIND_TALENT);
+    const auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    return shard.find(talentId);
+}
+
+bool TalentManager::withTalent(const std::string& talentId,
+                               const std::function<void(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::WITH_TALENT);
+    const auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    const Talent* talent = shard.find(talentId);
+    if (talent == nullptr) {
+        return false;
+    }
+    visitor(*talent);
+    return true;
+}
+
+bool TalentManager::containsTalent(const std::string& talentId) const {
+    OperationScope timing(OperationId::CONTAINS_TALENT);
+    const auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    return shard.findHandle(talentId).valid();
+}
+
+std::size_t TalentManager::talentCount() const {
+    OperationScope timing(OperationId::TALENT_COUNT);
+    return talents_.size();
+}
+
+TalentHandle TalentManager::findTalentHandle(const std::string& talentId) const {
+    OperationScope timing(OperationId::FIND_TALENT_HANDLE);
+    const auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    return shard.findHandle(talentId);
+}
+
+const Talent* TalentManager::findTalent(TalentHandle handle) const {
+    OperationScope timing(OperationId::FIND_TALENT);
+    const auto& shard = talents_.shardOf(handle);
+    ReadLock lock(shard.mutex);
+    return shard.find(handle);
+}
+
+void TalentManager::attachLog(MutationLog* log) {
+    log_ = log;
+}
+
+void TalentManager::attachChangeFeed(ChangeFeed* feed) {
+    feed_ = feed;
+}
+
+bool TalentManager::restoreTalent(const Talent& talent) {
+    OperationScope timing(OperationId::RESTORE_TALENT);
+    if (talent.id.empty()) {
+        return false;
+    }
+    auto& shard = talents_.shardFor(talent.id);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talent.id);
+    if (Talent* stored = shard.find(handle)) {
+        unindexTalent(shard.index, shard.localIndex(handle), *stored);
+        *stored = talent;
+    } else {
+        handle = shard.insert(talent.id, talent);
+    }
+    Talent& restored = *shard.find(handle);
+    indexProjects(shard.index, shard.localIndex(handle), restored);
+    markTalentChanged(shard, handle, restored);
+    indexTalent(shard.index, shard.localIndex(handle), restored);
+    return true;
 }
 
 bool TalentManager::addSkill(const std::string& talentId, SkillType skill) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::ADD_SKILL);
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr) {
         return false;
     }
-    talents_[talentId].skills.insert(skill);
+    talent->skills.insert(skill);
+    markTalentChanged(shard, handle, *talent);
     return true;
 }
 
 bool TalentManager::removeSkill(const std::string& talentId, SkillType skill) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::REMOVE_SKILL);
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr || talent->skills.erase(skill) == 0) {
         return false;
     }
-    return talents_[talentId].skills.erase(skill) > 0;
+    markTalentChanged(shard, handle, *talent);
+    return true;
 }
 
 std::vector<Talent> TalentManager::getTalentsBySkill(SkillType skill) {
+    OperationScope timing(OperationId::GET_TALENTS_BY_SKILL);
     std::vector<Talent> result;
-    for (const auto& pair : talents_) {
-        if (pair.second.skills.find(skill) != pair.second.skills.end()) {
-            result.push_back(pair.second);
-        }
-    }
+    forEachTalentWithSkill(skill, [&](const Talent& talent) {
+        result.push_back(talent);
+        return true;
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
+void TalentManager::forEachTalentWithSkill(SkillType skill,
+                                           const std::function<bool(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_TALENT_WITH_SKILL);
+    visitMatchingKeys(SkillSet::bit(skill), visitor);
+}
+
+void TalentManager::forEachAvailableTalentWithSkills(SkillSet requiredSkills,
+                                                     const std::function<bool(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_AVAILABLE_TALENT_WITH_SKILLS);
+    visitMatchingKeys(static_cast<std::uint16_t>(requiredSkills.mask() | kAvailableKeyBit), visitor);
+}
+
 bool TalentManager::updateAvailability(const std::string& talentId, bool isAvailable) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::UPDATE_AVAILABILITY);
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr) {
         return false;
     }
-    talents_[talentId].isAvailable = isAvailable;
+    talent->isAvailable = isAvailable;
+    markTalentChanged(shard, handle, *talent);
     return true;
 }
 
 std::vector<Talent> TalentManager::getAvailableTalents() {
+    OperationScope timing(OperationId::GET_AVAILABLE_TALENTS);
     std::vector<Talent> result;
-    for (const auto& pair : talents_) {
-        if (pair.second.isAvailable) {
-            result.push_back(pair.second);
-        }
+    forEachAvailableTalent([&](const Talent& talent) {
+        result.push_back(talent);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+void TalentManager::forEachAvailableTalent(const std::function<bool(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_AVAILABLE_TALENT);
+    visitMatchingKeys(kAvailableKeyBit, visitor);
+}
+
+std::vector<std::string> TalentManager::findAvailableTalentsWithSkills(SkillSet requiredSkills) const {
+    OperationScope timing(OperationId::FIND_AVAILABLE_TALENTS_WITH_SKILLS);
+    std::vector<std::string> result;
+    forEachAvailableTalentWithSkills(requiredSkills, [&](const Talent& talent) {
+        result.push_back(talent.id);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+std::vector<TalentCandidate> TalentManager::findAvailableCandidates(SkillSet requiredSkills,
+                                                                    std::size_t limit) const {
+    OperationScope timing(OperationId::FIND_AVAILABLE_CANDIDATES);
+    std::vector<TalentCandidate> result;
+    if (limit == 0) {
+        return result;
     }
+    forEachAvailableCandidate(requiredSkills, [&](const TalentCandidate& candidate, const Talent&) {
+        result.push_back(candidate);
+        return result.size() < limit;
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
-bool TalentManager::assignProject(const std::string& talentId, const std::string& projectId) {
-    if (talents_.find(talentId) == talents_.end()) {
-        return false;
+void TalentManager::forEachAvailableCandidate(
+    SkillSet requiredSkills,
+    const std::function<bool(const TalentCandidate&, const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_AVAILABLE_CANDIDATE);
+    std::vector<std::size_t> slots;
+    auto required = static_cast<std::uint16_t>(requiredSkills.mask() | kAvailableKeyBit);
+
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        const auto& keys = shard.index.matchKeys;
+        slots.clear();
+        matchSkillKeys(keys.data(), keys.size(), required, slots);
+        for (std::size_t slot : slots) {
+            auto index = static_cast<std::uint32_t>(slot);
+            const Talent& talent = *shard.atLocalIndex(index);
+            if (!visitor(TalentCandidate{shard.handleAtLocalIndex(index), talent.id, shard.index.versions[slot]},
+                         talent)) {
+                return;
+            }
+        }
     }
-    auto& talent = talents_[talentId];
-    if (std::find(talent.completedProjects.begin(), 
-                  talent.completedProjects.end(), 
-                  projectId) == talent.completedProjects.end()) {
-        talent.completedProjects.push_back(projectId);
+}
+
+std::vector<RankedCandidate> TalentManager::findRankedCandidates(SkillSet requiredSkills, std::size_t limit,
+                                                                 const CandidateRanking& ranking) const {
+    OperationScope timing(OperationId::FIND_RANKED_CANDIDATES);
+    std::vector<RankedCandidate> kept;  // Max-heap on cost
+    if (limit == 0) {
+        return kept;
+    }
+    kept.reserve(limit);
+    auto cheaper = [](const RankedCandidate& a, const RankedCandidate& b) { return a.cost < b.cost; };
+    auto required = static_cast<std::uint16_t>(requiredSkills.mask() | kAvailableKeyBit);
+    std::vector<std::size_t> slots;
+
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        const auto& index = shard.index;
+
+        // costFloor is the talent's cost before load, which load only raises
+        auto offer = [&](std::uint32_t slot, double costFloor) {
+            const Talent& talent = *shard.atLocalIndex(slot);
+            double loadMultiplier = 1.0 + ranking.loadFactor * static_cast<double>(talent.completedProjects.size());
+            double cost = costFloor * loadMultiplier;
+            if (kept.size() == limit) {
+                if (cost >= kept.front().cost) {
+                    return;
+                }
+                std::pop_heap(kept.begin(), kept.end(), cheaper);
+                kept.pop_back();
+            }
+            kept.push_back(RankedCandidate{
+                TalentCandidate{shard.handleAtLocalIndex(slot), talent.id, index.versions[slot]},
+                talent.hourlyRate, cost});
+            std::push_heap(kept.begin(), kept.end(), cheaper);
+        };
+
+        // Walking the rate order pays off when matches are dense enough to
+        // fill the heap early, about limit / density steps against one visit
+        // per match; sparse matches are ranked straight from a key scan. The
+        // rarest required skill bounds the matches, so no scan is needed to
+        // choose.
+        const auto& keys = index.matchKeys;
+        std::size_t bound = matchBound(index, required);
+        if (bound == 0) {
+            continue;
+        }
+        if (bound * bound <= limit * keys.size()) {
+            slots.clear();
+            matchSkillKeys(keys.data(), keys.size(), required, slots);
+            for (std::size_t slot : slots) {
+                const Talent& talent = *shard.atLocalIndex(static_cast<std::uint32_t>(slot));
+                if (talent.hourlyRate <= ranking.maxHourlyRate) {
+                    auto level = static_cast<std::size_t>(talent.experienceLevel);
+                    offer(static_cast<std::uint32_t>(slot),
+                          std::max(0.0, talent.hourlyRate) * ranking.levelFactors[level]);
+                }
+            }
+            continue;
+        }
+
+        // Merge the level buckets by cost floor, which only grows along each
+        // bucket, and stop once the next floor cannot beat the dearest kept
+        std::array<RateIndex::const_iterator, kExperienceLevelCount> cursors;
+        for (std::size_t level = 0; level < kExperienceLevelCount; ++level) {
+            cursors[level] = index.byLevel[level].begin();
+        }
+        while (true) {
+            std::size_t next = kExperienceLevelCount;
+            double costFloor = std::numeric_limits<double>::infinity();
+            for (std::size_t level = 0; level < kExperienceLevelCount; ++level) {
+                if (cursors[level] == index.byLevel[level].end() || cursors[level]->first > ranking.maxHourlyRate) {
+                    continue;
+                }
+                double levelCostFloor = std::max(0.0, cursors[level]->first) * ranking.levelFactors[level];
+                if (levelCostFloor < costFloor) {
+                    costFloor = levelCostFloor;
+                    next = level;
+                }
+            }
+            if (next == kExperienceLevelCount || (kept.size() == limit && costFloor >= kept.front().cost)) {
+                break;
+            }
+            std::uint32_t slot = (cursors[next]++)->second;
+            if ((keys[slot] & required) == required) {
+                offer(slot, costFloor);
+            }
+        }
+    }
+    std::sort_heap(kept.begin(), kept.end(), cheaper);
+    timing.setResultSize(kept.size());
+    return kept;
+}
+
+bool TalentManager::commitProjectAssignment(const std::vector<TalentCandidate>& candidates,
+                                            const std::string& projectId) {
+    OperationScope timing(OperationId::COMMIT_PROJECT_ASSIGNMENT);
+    DurableScope scope(log_);
+    auto commit = [&] {
+        std::vector<std::size_t> shardNumbers;
+        shardNumbers.reserve(candidates.size());
+        for (const auto& candidate : candidates) {
+            shardNumbers.push_back(talents_.shardNumberOf(candidate.handle));
+        }
+        auto locks = talents_.lockExclusive(std::move(shardNumbers));
+
+        // Validate every candidate before touching any of them
+        for (const auto& candidate : candidates) {
+            const auto& shard = talents_.shardOf(candidate.handle);
+            if (shard.find(candidate.handle) == nullptr ||
+                shard.index.versions[shard.localIndex(candidate.handle)] != candidate.version) {
+                return false;
+            }
+        }
+
+        for (const auto& candidate : candidates) {
+            auto& shard = talents_.shardOf(candidate.handle);
+            Talent& talent = *shard.find(candidate.handle);
+            if (addProjectTo(shard.index, shard.localIndex(candidate.handle), talent, projectId)) {
+                markTalentChanged(shard, candidate.handle, talent);
+            }
+        }
         return true;
+    };
+    if (projectManager_ == nullptr) {
+        return commit();
     }
-    return false;
+    // The project is locked first and gains the whole team under one record;
+    // a project deleted meanwhile fails the commit
+    std::vector<std::string> team;
+    team.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+        team.push_back(candidate.id);
+    }
+    return projectManager_->commitTeam(projectId, team, commit);
 }
 
-bool TalentManager::removeProject(const std::string& talentId, const std::string& projectId) {
-    if (talents_.find(talentId) == talents_.end()) {
+bool TalentManager::assignProject(const std::string& talentId, const std::string& projectId) {
+    OperationScope timing(OperationId::ASSIGN_PROJECT);
+    if (projectManager_ != nullptr) {
+        return projectManager_->linkPair(projectId, talentId, true);
+    }
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr || !addProjectTo(shard.index, shard.localIndex(handle), *talent, projectId)) {
         return false;
     }
-    auto& talent = talents_[talentId];
-    auto it = std::find(talent.completedProjects.begin(), 
-                       talent.completedProjects.end(), 
-                       projectId);
-    if (it != talent.completedProjects.end()) {
-        talent.completedProjects.erase(it);
-        return true;
+    markTalentChanged(shard, handle, *talent);
+    return true;
+}
+
+bool TalentManager::removeProject(const std::string& talentId, const std::string& projectId) {
+    OperationScope timing(OperationId::REMOVE_PROJECT);
+    if (projectManager_ != nullptr) {
+        return projectManager_->linkPair(projectId, talentId, false);
+    }
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr || !dropProjectFrom(shard.index, shard.localIndex(handle), *talent, projectId)) {
+        return false;
     }
-    return false;
+    markTalentChanged(shard, handle, *talent);
+    return true;
 }
 
 std::vector<std::string> TalentManager::getTalentProjects(const std::string& talentId) {
-    if (talents_.find(talentId) == talents_.end()) {
+    OperationScope timing(OperationId::GET_TALENT_PROJECTS);
+    auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    const Talent* talent = shard.find(talentId);
+    if (talent == nullptr) {
         throw std::runtime_error("Talent not found");
     }
-    return talents_[talentId].completedProjects;
+    timing.setResultSize(talent->completedProjects.size());
+    return talent->completedProjects;
+}
+
+const std::vector<std::string>* TalentManager::findTalentProjects(const std::string& talentId) const {
+    OperationScope timing(OperationId::FIND_TALENT_PROJECTS);
+    const Talent* talent = findTalent(talentId);
+    return talent == nullptr ? nullptr : &talent->completedProjects;
 }
 
 std::vector<Talent> TalentManager::searchTalents(const std::string& query) {
+    OperationScope timing(OperationId::SEARCH_TALENTS);
+    std::vector<Talent> result = searchTalents(query, std::numeric_limits<std::size_t>::max());
+    timing.setResultSize(result.size());
+    return result;
+}
+
+std::vector<Talent> TalentManager::searchTalents(const std::string& query, std::size_t limit) {
+    OperationScope timing(OperationId::SEARCH_TALENTS);
     std::vector<Talent> result;
-    std::string lowercaseQuery = query;
-    std::transform(lowercaseQuery.begin(), lowercaseQuery.end(), 
-                  lowercaseQuery.begin(), ::tolower);
-    
-    for (const auto& pair : talents_) {
-        const auto& talent = pair.second;
-        std::string lowercaseName = talent.name;
-        std::transform(lowercaseName.begin(), lowercaseName.end(), 
-                      lowercaseName.begin(), ::tolower);
-        
-        if (lowercaseName.find(lowercaseQuery) != std::string::npos) {
-            result.push_back(talent);
-        }
+    if (limit == 0) {
+        return result;
     }
+    forEachTalentMatching(query, [&](const Talent& talent) {
+        result.push_back(talent);
+        return result.size() < limit;
+    });
+    timing.setResultSize(result.size());
     return result;
 }
 
-std::vector<Talent> TalentManager::getTalentsByExperienceLevel(ExperienceLevel level) {
-    std::vector<Talent> result;
-    for (const auto& pair : talents_) {
-        if (pair.second.experienceLevel == level) {
-            result.push_back(pair.second);
+void TalentManager::forEachTalentMatching(const std::string& query,
+                                          const std::function<bool(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_TALENT_MATCHING);
+    std::string foldedQuery;
+    TrigramIndex::fold(query, foldedQuery);
+    std::string buffer;
+
+    if (foldedQuery.size() < TrigramIndex::kMinQueryLength) {
+        // Too short to have a trigram
+        forEachStoredTalent([&](const Talent& talent) {
+            return !matchesSearch(talent, foldedQuery, buffer) || visitor(talent);
+        });
+        return;
+    }
+
+    std::vector<TrigramIndex::Slot> slots;
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        shard.index.text.findCandidates(foldedQuery, slots);
+        for (TrigramIndex::Slot slot : slots) {
+            const Talent& talent = *shard.atLocalIndex(slot);
+            if (matchesSearch(talent, foldedQuery, buffer) && !visitor(talent)) {
+                return;
+            }
         }
     }
+}
+
+std::vector<Talent> TalentManager::getTalentsByExperienceLevel(ExperienceLevel level) {
+    OperationScope timing(OperationId::GET_TALENTS_BY_EXPERIENCE_LEVEL);
+    TalentFilter filter;
+    filter.experienceLevel = level;
+    std::vector<Talent> result = findTalents(filter);
+    timing.setResultSize(result.size());
     return result;
 }
 
 std::vector<Talent> TalentManager::getTalentsByHourlyRateRange(double minRate, double maxRate) {
+    OperationScope timing(OperationId::GET_TALENTS_BY_HOURLY_RATE_RANGE);
+    TalentFilter filter;
+    filter.minRate = minRate;
+    filter.maxRate = maxRate;
+    std::vector<Talent> result = findTalents(filter);
+    timing.setResultSize(result.size());
+    return result;
+}
+
+std::vector<Talent> TalentManager::findTalents(const TalentFilter& filter) const {
+    OperationScope timing(OperationId::FIND_TALENTS);
     std::vector<Talent> result;
-    for (const auto& pair : talents_) {
-        if (pair.second.hourlyRate >= minRate && pair.second.hourlyRate <= maxRate) {
-            result.push_back(pair.second);
+    forEachTalent(filter, [&](const Talent& talent) {
+        result.push_back(talent);
+        return true;
+    });
+    timing.setResultSize(result.size());
+    return result;
+}
+
+void TalentManager::forEachTalent(const TalentFilter& filter,
+                                  const std::function<bool(const Talent&)>& visitor) const {
+    OperationScope timing(OperationId::FOR_EACH_TALENT);
+    if (!(filter.minRate <= filter.maxRate)) {
+        return;
+    }
+    auto required = static_cast<std::uint16_t>(filter.requiredSkills.mask() |
+                                               (filter.availableOnly ? kAvailableKeyBit : 0));
+    std::size_t firstLevel = 0;
+    std::size_t lastLevel = kExperienceLevelCount;
+    if (filter.experienceLevel) {
+        firstLevel = static_cast<std::size_t>(*filter.experienceLevel);
+        lastLevel = firstLevel + 1;
+    }
+    // Without a rate bound or level the slot-ordered keys are cheaper to scan
+    // than the rate buckets are to walk
+    bool anyRate = filter.minRate == -std::numeric_limits<double>::infinity() &&
+                   filter.maxRate == std::numeric_limits<double>::infinity();
+    bool scanSlots = anyRate && !filter.experienceLevel;
+
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        const auto& index = shard.index;
+        auto matches = [&](std::uint32_t slot) {
+            return (index.matchKeys[slot] & required) == required &&
+                   (!filter.timezone || index.timezones[slot] == *filter.timezone) &&
+                   (!filter.preferredLanguage || index.languages[slot] == *filter.preferredLanguage);
+        };
+
+        if (scanSlots) {
+            for (std::uint32_t slot = 0; slot < index.matchKeys.size(); ++slot) {
+                // Free slots hold key 0, so they can only pass an empty filter
+                const Talent* talent = matches(slot) ? shard.atLocalIndex(slot) : nullptr;
+                if (talent != nullptr && !visitor(*talent)) {
+                    return;
+                }
+            }
+            continue;
+        }
+        for (std::size_t level = firstLevel; level < lastLevel; ++level) {
+            const RateIndex& bucket = index.byLevel[level];
+            auto it = bucket.lower_bound({filter.minRate, 0});
+            for (; it != bucket.end() && it->first <= filter.maxRate; ++it) {
+                if (matches(it->second) && !visitor(*shard.atLocalIndex(it->second))) {
+                    return;
+                }
+            }
+        }
+    }
+}
+
+void TalentManager::refreshColumns(TalentColumns& columns) const {
+    OperationScope timing(OperationId::REFRESH_COLUMNS);
+    columns.segments_.resize(talents_.shardCount());
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        auto& segment = columns.segments_[i];
+        ReadLock lock(shard.mutex);
+
+        auto copySlot = [&](std::uint32_t slot) {
+            const Talent* talent = shard.atLocalIndex(slot);
+            if (talent == nullptr) {
+                segment.keys[slot] = 0;
+                segment.rates[slot] = 0.0;
+                segment.levels[slot] = 0;
+                segment.timezones[slot] = 0;
+                segment.languages[slot] = 0;
+                return;
+            }
+            segment.keys[slot] = static_cast<std::uint16_t>(talent->skills.mask() | TalentColumns::kPresentBit |
+                                                            (talent->isAvailable ? TalentColumns::kAvailableBit : 0));
+            segment.rates[slot] = talent->hourlyRate;
+            segment.levels[slot] = static_cast<std::uint8_t>(talent->experienceLevel);
+            segment.timezones[slot] = talent->timezone.id();
+            segment.languages[slot] = talent->preferredLanguage.id();
+        };
+
+        std::size_t rows = shard.slotCount();
+        segment.keys.resize(rows, 0);
+        segment.rates.resize(rows, 0.0);
+        segment.levels.resize(rows, 0);
+        segment.timezones.resize(rows, 0);
+        segment.languages.resize(rows, 0);
+
+        const auto& log = shard.index.changedSlots;
+        if (!segment.built || segment.logEpoch != shard.index.changeLogEpoch) {
+            for (std::uint32_t slot = 0; slot < rows; ++slot) {
+                copySlot(slot);
+            }
+        } else {
+            for (std::size_t entry = segment.logPosition; entry < log.size(); ++entry) {
+                copySlot(log[entry]);
+            }
+        }
+        segment.built = true;
+        segment.logEpoch = shard.index.changeLogEpoch;
+        segment.logPosition = log.size();
+    }
+}
+
+std::uint16_t TalentManager::matchKeyFor(const Talent& talent) {
+    return static_cast<std::uint16_t>(talent.skills.mask() |
+                                      (talent.isAvailable ? kAvailableKeyBit : 0));
+}
+
+void TalentManager::setMatchKey(ShardIndex& index, std::uint32_t slot, std::uint16_t key) {
+    // Keeps the availability counts in step with the key they summarize
+    auto count = [&index](std::uint16_t counted, std::int32_t delta) {
+        if ((counted & kAvailableKeyBit) == 0) {
+            return;
+        }
+        index.availableCount += static_cast<std::uint32_t>(delta);
+        for (std::size_t skill = 0; skill < kSkillTypeCount; ++skill) {
+            if ((counted & (1u << skill)) != 0) {
+                index.availableBySkill[skill] += static_cast<std::uint32_t>(delta);
+            }
+        }
+    };
+    count(index.matchKeys[slot], -1);
+    index.matchKeys[slot] = key;
+    count(key, 1);
+}
+
+std::size_t TalentManager::matchBound(const ShardIndex& index, std::uint16_t required) {
+    std::size_t bound = index.availableCount;
+    for (std::size_t skill = 0; skill < kSkillTypeCount; ++skill) {
+        if ((required & (1u << skill)) != 0) {
+            bound = std::min<std::size_t>(bound, index.availableBySkill[skill]);
+        }
+    }
+    return bound;
+}
+
+void TalentManager::markTalentChanged(Store::Shard& shard, TalentHandle handle, const Talent& talent) {
+    auto& index = shard.index;
+    if (index.matchKeys.size() < shard.slotCount()) {
+        index.matchKeys.resize(shard.slotCount(), 0);
+        index.versions.resize(shard.slotCount(), 0);
+        index.timezones.resize(shard.slotCount());
+        index.languages.resize(shard.slotCount());
+    }
+    std::uint32_t slot = shard.localIndex(handle);
+    setMatchKey(index, slot, matchKeyFor(talent));
+    index.timezones[slot] = talent.timezone;
+    index.languages[slot] = talent.preferredLanguage;
+    ++index.versions[slot];
+    logSlotChange(shard, slot);
+    if (log_ != nullptr) {
+        DurableScope::note(log_->putTalent(talent));
+    }
+    if (feed_ != nullptr) {
+        feed_->publish(ChangeEntity::TALENT, ChangeType::PUT, talent.id);
+    }
+}
+
+void TalentManager::logSlotChange(Store::Shard& shard, std::uint32_t slot) {
+    auto& index = shard.index;
+    if (index.changedSlots.size() >= std::max<std::size_t>(1024, shard.slotCount())) {
+        index.changedSlots.clear();
+        ++index.changeLogEpoch;
+    }
+    index.changedSlots.push_back(slot);
+}
+
+void TalentManager::indexTalent(ShardIndex& index, std::uint32_t slot, const Talent& talent) {
+    index.text.add(slot, {talent.name, talent.email});
+    index.byLevel[static_cast<std::size_t>(talent.experienceLevel)].insert({talent.hourlyRate, slot});
+}
+
+void TalentManager::unindexTalent(ShardIndex& index, std::uint32_t slot, const Talent& talent) {
+    index.text.remove(slot, {talent.name, talent.email});
+    index.byLevel[static_cast<std::size_t>(talent.experienceLevel)].erase({talent.hourlyRate, slot});
+}
+
+void TalentManager::indexProjects(ShardIndex& index, std::uint32_t slot, Talent& talent) {
+    index.projects.erase(slot);
+    if (talent.completedProjects.empty()) {
+        return;
+    }
+    indexLinks(index.projects[slot], talent.completedProjects);
+}
+
+bool TalentManager::addProjectTo(ShardIndex& index, std::uint32_t slot, Talent& talent,
+                                 const std::string& projectId) {
+    return addLink(index.projects[slot], talent.completedProjects, projectId);
+}
+
+bool TalentManager::dropProjectFrom(ShardIndex& index, std::uint32_t slot, Talent& talent,
+                                    const std::string& projectId) {
+    auto projects = index.projects.find(slot);
+    if (projects == index.projects.end() || !removeLink(projects->second, talent.completedProjects, projectId)) {
+        return false;
+    }
+    if (projects->second.empty()) {
+        index.projects.erase(projects);
+    }
+    return true;
+}
+
+bool TalentManager::linkProjectSide(const std::string& talentId, const std::string& projectId, bool linked,
+                                    bool* changed) {
+    DurableScope scope(log_);
+    auto& shard = talents_.shardFor(talentId);
+    WriteLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    Talent* talent = shard.find(handle);
+    if (talent == nullptr) {
+        return false;
+    }
+    std::uint32_t slot = shard.localIndex(handle);
+    if (linked ? addProjectTo(shard.index, slot, *talent, projectId)
+               : dropProjectFrom(shard.index, slot, *talent, projectId)) {
+        markTalentChanged(shard, handle, *talent);
+        if (changed != nullptr) {
+            *changed = true;
+        }
+    }
+    return true;
+}
+
+bool TalentManager::holdsProject(const std::string& talentId, const std::string& projectId) const {
+    const auto& shard = talents_.shardFor(talentId);
+    ReadLock lock(shard.mutex);
+    TalentHandle handle = shard.findHandle(talentId);
+    if (!handle.valid()) {
+        return false;
+    }
+    auto projects = shard.index.projects.find(shard.localIndex(handle));
+    return projects != shard.index.projects.end() && projects->second.count(projectId) > 0;
+}
+
+bool TalentManager::matchesSearch(const Talent& talent, const std::string& foldedQuery, std::string& buffer) {
+    return TrigramIndex::containsFolded(talent.name, foldedQuery, buffer) ||
+           TrigramIndex::containsFolded(talent.email, foldedQuery, buffer);
+}
+
+void TalentManager::visitMatchingKeys(std::uint16_t required,
+                                      const std::function<bool(const Talent&)>& visitor) const {
+    std::vector<std::size_t> slots;
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        const auto& keys = shard.index.matchKeys;
+        slots.clear();
+        matchSkillKeys(keys.data(), keys.size(), required, slots);
+        for (std::size_t slot : slots) {
+            if (!visitor(*shard.atLocalIndex(static_cast<std::uint32_t>(slot)))) {
+                return;
+            }
+        }
+    }
+}
+
+template <typename Visitor>
+void TalentManager::forEachStoredTalent(Visitor&& visitor) const {
+    for (std::size_t i = 0; i < talents_.shardCount(); ++i) {
+        const auto& shard = talents_.shard(i);
+        ReadLock lock(shard.mutex);
+        bool keepGoing = true;
+        shard.forEach([&](TalentHandle, const Talent& talent) {
+            keepGoing = visitor(talent);
+            return keepGoing;
+        });
+        if (!keepGoing) {
+            return;
         }
     }
-    return result;
 }
 
 } // namespace imagined 
\ No newline at end of file
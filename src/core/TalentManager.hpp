@@ -1,12 +1,32 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <array>
+#include <limits>
+#include <memory_resource>
+#include <optional>
 #include <set>
+#include <utility>
 #include <unordered_map>
+#include "EnumNames.hpp"
+#include "Handle.hpp"
+#include "ChangeFeed.hpp"
+#include "LinkPositions.hpp"
+#include "MutationLog.hpp"
+#include "ShardedStore.hpp"
+#include "Symbol.hpp"
+#include "TrigramIndex.hpp"
 
 namespace imagined {
 
+class ProjectManager;
+
 enum class SkillType {
     THREE_D_DESIGN,
     APP_DESIGN,
@@ -20,6 +40,73 @@ enum class SkillType {
     PACKAGING_DESIGN
 };
 
+constexpr std::size_t kSkillTypeCount = 10;
+
+constexpr std::array<std::string_view, kSkillTypeCount> kSkillTypeNames = {
+    "THREE_D_DESIGN", "APP_DESIGN", "WEB_DESIGN", "MOTION_DESIGN", "BRAND_IDENTITY",
+    "VIDEO_PRODUCTION", "TWO_D_ANIMATION", "PITCH_DECK", "AD_GRAPHICS", "PACKAGING_DESIGN"
+};
+
+constexpr std::string_view skillTypeName(SkillType skill) {
+    return enumName(skill, kSkillTypeNames);
+}
+
+// Accepts the enumerator name or its number, e.g. "WEB_DESIGN" or "2"
+constexpr std::optional<SkillType> parseSkillType(std::string_view text) {
+    return parseEnumName<SkillType>(text, kSkillTypeNames);
+}
+
+static_assert(parseSkillType("PACKAGING_DESIGN") == SkillType::PACKAGING_DESIGN, "skill names out of order");
+
+// Set of skills packed into one bit per SkillType.
+class SkillSet {
+public:
+    using Mask = std::uint16_t;
+
+    class const_iterator {
+    public:
+        constexpr explicit const_iterator(Mask remaining) : remaining_(remaining) {}
+        SkillType operator*() const;
+        const_iterator& operator++() { remaining_ &= static_cast<Mask>(remaining_ - 1); return *this; }
+        constexpr bool operator==(const const_iterator& other) const { return remaining_ == other.remaining_; }
+        constexpr bool operator!=(const const_iterator& other) const { return remaining_ != other.remaining_; }
+
+    private:
+        Mask remaining_;
+    };
+
+    constexpr SkillSet() = default;
+    constexpr explicit SkillSet(Mask mask) : mask_(mask & kAllSkills) {}
+    constexpr SkillSet(std::initializer_list<SkillType> skills) {
+        for (SkillType skill : skills) {
+            mask_ |= bit(skill);
+        }
+    }
+
+    static constexpr Mask bit(SkillType skill) {
+        return static_cast<Mask>(1u << static_cast<unsigned>(skill));
+    }
+
+    bool insert(SkillType skill);
+    std::size_t erase(SkillType skill);
+    constexpr bool contains(SkillType skill) const { return (mask_ & bit(skill)) != 0; }
+    constexpr bool containsAll(SkillSet other) const { return (mask_ & other.mask_) == other.mask_; }
+    std::size_t size() const;
+    constexpr bool empty() const { return mask_ == 0; }
+    constexpr Mask mask() const { return mask_; }
+
+    const_iterator begin() const { return const_iterator(mask_); }
+    const_iterator end() const { return const_iterator(0); }
+
+    constexpr bool operator==(const SkillSet& other) const { return mask_ == other.mask_; }
+    constexpr bool operator!=(const SkillSet& other) const { return mask_ != other.mask_; }
+
+    static constexpr Mask kAllSkills = static_cast<Mask>((1u << kSkillTypeCount) - 1);
+
+private:
+    Mask mask_ = 0;
+};
+
 enum class ExperienceLevel {
     JUNIOR,
     MID_LEVEL,
@@ -27,22 +114,76 @@ enum class ExperienceLevel {
     LEAD
 };
 
+constexpr std::size_t kExperienceLevelCount = 4;
+
 struct Talent {
     std::string id;
     std::string name;
     std::string email;
-    std::set<SkillType> skills;
+    SkillSet skills;
     ExperienceLevel experienceLevel;
     std::vector<std::string> completedProjects;
     double hourlyRate;
     bool isAvailable;
-    std::string timezone;
-    std::string preferredLanguage;
+    Symbol timezone;
+    Symbol preferredLanguage;
 };
 
+// A talent as seen by an optimistic transaction: the version changes on every
+// mutation of the talent, so an unchanged version means the read is current.
+struct TalentCandidate {
+    TalentHandle handle;
+    std::string id;
+    std::uint64_t version;
+};
+
+// Cost model of findRankedCandidates: a talent costs max(0, hourlyRate) x
+// levelFactors[experienceLevel] x (1 + loadFactor x its recorded projects).
+// Factors must not be negative.
+struct CandidateRanking {
+    std::array<double, kExperienceLevelCount> levelFactors{1.0, 1.0, 1.0, 1.0};
+    double loadFactor = 0.0;
+    double maxHourlyRate = std::numeric_limits<double>::infinity();  // Dearer talents are skipped
+};
+
+struct RankedCandidate {
+    TalentCandidate candidate;
+    double hourlyRate;
+    double cost;
+};
+
+class TalentColumns;
+
+// Conjunctive talent query; every set criterion must hold
+struct TalentFilter {
+    std::optional<ExperienceLevel> experienceLevel;
+    double minRate = -std::numeric_limits<double>::infinity();
+    double maxRate = std::numeric_limits<double>::infinity();
+    SkillSet requiredSkills;
+    bool availableOnly = false;
+    std::optional<Symbol> timezone;
+    std::optional<Symbol> preferredLanguage;
+};
+
+// Talents are stored in a sharded slot map and addressed internally by
+// TalentHandle; the UUID string is only mapped to a handle at the public API
+// boundary.
+//
+// Thread safety: every method may be called concurrently. Talents are sharded
+// by ID hash and each shard has its own reader-writer lock; the packed match
+// keys are kept per shard under the same lock.
+//
+// Read views: forEach* and with* run the visitor while holding the shard's
+// read lock, so the visitor must not call back into mutating methods of the
+// same manager. find* returns a raw pointer (nullptr when missing) that stays
+// valid only until the next mutating call; it is not protected against
+// concurrent writers and is meant for single-threaded use.
 class TalentManager {
 public:
-    TalentManager();
+    // Storage and indexes allocate from `resource`; see ProjectManager for the
+    // requirements on it
+    explicit TalentManager(std::size_t shardCount = 1,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
     ~TalentManager();
 
     // Talent CRUD operations
@@ -50,29 +191,162 @@ public:
     bool updateTalent(const std::string& talentId, const Talent& talent);
     bool removeTalent(const std::string& talentId);
     Talent getTalent(const std::string& talentId);
+    const Talent* findTalent(const std::string& talentId) const;
+    bool withTalent(const std::string& talentId,
+                    const std::function<void(const Talent&)>& visitor) const;
+    bool containsTalent(const std::string& talentId) const;
+    std::size_t talentCount() const;
+
+    // Handle-based access
+    TalentHandle findTalentHandle(const std::string& talentId) const;
+    const Talent* findTalent(TalentHandle handle) const;
+
+    // Persistence. Once a log is attached every mutation is recorded in it
+    // and returns only after its record is durable, or throws
+    // std::runtime_error if the log failed; attach before concurrent use.
+    // restoreTalent inserts or replaces a talent under its own ID and is
+    // meant for recovery, before a log is attached.
+    void attachLog(MutationLog* log);
+    // Every mutation, restores included, publishes a TALENT event to the
+    // attached feed; attach before concurrent use
+    void attachChangeFeed(ChangeFeed* feed);
+    bool restoreTalent(const Talent& talent);
 
     // Skill management
     bool addSkill(const std::string& talentId, SkillType skill);
     bool removeSkill(const std::string& talentId, SkillType skill);
     std::vector<Talent> getTalentsBySkill(SkillType skill);
+    std::vector<std::string> findAvailableTalentsWithSkills(SkillSet requiredSkills) const;
+    void forEachTalentWithSkill(SkillType skill,
+                                const std::function<bool(const Talent&)>& visitor) const;
+    void forEachAvailableTalentWithSkills(SkillSet requiredSkills,
+                                          const std::function<bool(const Talent&)>& visitor) const;
+
+    // Optimistic transactions: read candidates without holding locks across
+    // calls, then commit only if none of them changed in between
+    std::vector<TalentCandidate> findAvailableCandidates(SkillSet requiredSkills, std::size_t limit) const;
+    void forEachAvailableCandidate(SkillSet requiredSkills,
+                                   const std::function<bool(const TalentCandidate&, const Talent&)>& visitor) const;
+    // The `limit` cheapest available talents holding requiredSkills under
+    // `ranking`, cheapest first. Each shard's experience buckets are walked
+    // in rate order, keeping the best `limit` in a bounded heap, and the walk
+    // stops once no talent left can beat the dearest one kept. A shard whose
+    // per-skill counts allow only a few matches is ranked from a key scan
+    // instead; the path is chosen from the counts, before either is taken.
+    std::vector<RankedCandidate> findRankedCandidates(SkillSet requiredSkills, std::size_t limit,
+                                                      const CandidateRanking& ranking) const;
+    bool commitProjectAssignment(const std::vector<TalentCandidate>& candidates,
+                                 const std::string& projectId);
 
     // Availability management
     bool updateAvailability(const std::string& talentId, bool isAvailable);
     std::vector<Talent> getAvailableTalents();
+    void forEachAvailableTalent(const std::function<bool(const Talent&)>& visitor) const;
 
-    // Project assignment
+    // Project assignment. Each project's position in completedProjects is
+    // indexed, so checking, adding or removing one is O(1); a removal moves
+    // the last project into its place, and repeated IDs are dropped on add
+    // and update. Only once ProjectManager::attachTalentManager has linked
+    // the two managers is every change, removing the talent and
+    // commitProjectAssignment included, applied to the projects' teams too. The project's lock is always taken before the
+    // talent's, so assignProject, removeProject and removeTalent go through
+    // the ProjectManager, and a project that add or update puts on the
+    // talent is checked against its team after the talent's lock is
+    // released; one that does not exist is taken off the talent again.
     bool assignProject(const std::string& talentId, const std::string& projectId);
     bool removeProject(const std::string& talentId, const std::string& projectId);
     std::vector<std::string> getTalentProjects(const std::string& talentId);
+    const std::vector<std::string>* findTalentProjects(const std::string& talentId) const;
 
-    // Search and filtering
+    // Search and filtering. A search matches talents whose name or email
+    // contains the query, ignoring ASCII case; queries of three or more
+    // characters are answered from a trigram index instead of a scan.
     std::vector<Talent> searchTalents(const std::string& query);
+    std::vector<Talent> searchTalents(const std::string& query, std::size_t limit);
+    void forEachTalentMatching(const std::string& query,
+                               const std::function<bool(const Talent&)>& visitor) const;
     std::vector<Talent> getTalentsByExperienceLevel(ExperienceLevel level);
     std::vector<Talent> getTalentsByHourlyRateRange(double minRate, double maxRate);
+    // Walks the rate range inside the requested experience bucket(s), or
+    // every slot when neither is restricted, and checks skills, availability,
+    // timezone and language against per-slot keys and symbols without
+    // touching talents that do not match
+    std::vector<Talent> findTalents(const TalentFilter& filter) const;
+    void forEachTalent(const TalentFilter& filter,
+                       const std::function<bool(const Talent&)>& visitor) const;
+
+    // Columnar snapshot for analytical scans; copies only the slots changed
+    // since `columns` was last refreshed
+    void refreshColumns(TalentColumns& columns) const;
 
 private:
-    std::unordered_map<std::string, Talent> talents_;
-    // Add more private members as needed
+    // (hourlyRate, local slot), so a rate range is one lower_bound and a walk
+    using RateIndex = std::pmr::set<std::pair<double, std::uint32_t>>;
+
+    // Packed matching keys (skill bits plus kAvailableKeyBit), change
+    // versions and the timezone and language symbols, all indexed by local
+    // slot. Free slots hold key 0 and never match. The trigram index covers name and email, and each experience
+    // level has its own rate-ordered bucket, all by local slot. changedSlots
+    // logs every changed slot for columnar snapshots; when it outgrows the
+    // shard it is cleared and changeLogEpoch bumped, forcing a full copy.
+    // availableCount and availableBySkill count the available talents, in
+    // all and per skill, bounding a query's matches without a scan.
+    struct ShardIndex {
+        explicit ShardIndex(std::pmr::memory_resource* resource)
+            : matchKeys(resource),
+              versions(resource),
+              timezones(resource),
+              languages(resource),
+              text(resource),
+              byLevel(makeContainerArray<RateIndex, kExperienceLevelCount>(resource)),
+              changedSlots(resource),
+              projects(resource) {}
+
+        std::pmr::vector<std::uint16_t> matchKeys;
+        std::pmr::vector<std::uint64_t> versions;
+        std::pmr::vector<Symbol> timezones;
+        std::pmr::vector<Symbol> languages;
+        TrigramIndex text;
+        std::array<RateIndex, kExperienceLevelCount> byLevel;
+        std::pmr::vector<std::uint32_t> changedSlots;
+        std::uint64_t changeLogEpoch = 0;
+        std::uint32_t availableCount = 0;
+        std::array<std::uint32_t, kSkillTypeCount> availableBySkill{};
+        // completedProjects of each talent that has any, by local slot
+        std::pmr::unordered_map<std::uint32_t, LinkPositions> projects;
+    };
+
+    using Store = ShardedStore<Talent, TalentTag, ShardIndex>;
+    Store talents_;
+    MutationLog* log_ = nullptr;
+    ChangeFeed* feed_ = nullptr;
+    ProjectManager* projectManager_ = nullptr;
+
+    friend class ProjectManager;
+
+    static constexpr std::uint16_t kAvailableKeyBit = 0x8000;
+
+    static std::uint16_t matchKeyFor(const Talent& talent);
+    static void setMatchKey(ShardIndex& index, std::uint32_t slot, std::uint16_t key);
+    static std::size_t matchBound(const ShardIndex& index, std::uint16_t required);
+    void markTalentChanged(Store::Shard& shard, TalentHandle handle, const Talent& talent);
+    static void logSlotChange(Store::Shard& shard, std::uint32_t slot);
+    static void indexTalent(ShardIndex& index, std::uint32_t slot, const Talent& talent);
+    static void unindexTalent(ShardIndex& index, std::uint32_t slot, const Talent& talent);
+    static void indexProjects(ShardIndex& index, std::uint32_t slot, Talent& talent);
+    static bool addProjectTo(ShardIndex& index, std::uint32_t slot, Talent& talent, const std::string& projectId);
+    static bool dropProjectFrom(ShardIndex& index, std::uint32_t slot, Talent& talent, const std::string& projectId);
+    // Entry points of the linked ProjectManager, called with the project's
+    // lock held. linkProjectSide adds or removes projectId on the talent and
+    // returns false if the talent does not exist.
+    bool linkProjectSide(const std::string& talentId, const std::string& projectId, bool linked,
+                         bool* changed = nullptr);
+    bool holdsProject(const std::string& talentId, const std::string& projectId) const;
+    static bool matchesSearch(const Talent& talent, const std::string& foldedQuery, std::string& buffer);
+    template <typename Visitor>
+    void forEachStoredTalent(Visitor&& visitor) const;
+    void visitMatchingKeys(std::uint16_t required,
+                           const std::function<bool(const Talent&)>& visitor) const;
 };
 
 } // namespace imagined 
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "TrigramIndex.hpp"
+#include <algorithm>
+
+namespace imagined {
+
+namespace {
+
+inline unsigned char foldByte(char c) {
+    auto byte = static_cast<unsigned char>(c);
+    return (byte >= 'A' && byte <= 'Z') ? static_cast<unsigned char>(byte + ('a' - 'A')) : byte;
+}
+
+inline std::uint32_t trigramAt(std::string_view text, std::size_t i) {
+    return (static_cast<std::uint32_t>(foldByte(text[i])) << 16) |
+           (static_cast<std::uint32_t>(foldByte(text[i + 1])) << 8) |
+           static_cast<std::uint32_t>(foldByte(text[i + 2]));
+}
+
+} // namespace
+
+void TrigramIndex::add(Slot slot, std::initializer_list<std::string_view> fields) {
+    std::vector<std::uint32_t> trigrams;
+    collectTrigrams(fields, trigrams);
+    for (std::uint32_t trigram : trigrams) {
+        auto& posting = postings_[trigram];
+        // Slots mostly grow, so appending is the common case
+        if (posting.empty() || posting.back() < slot) {
+            posting.push_back(slot);
+            continue;
+        }
+        auto it = std::lower_bound(posting.begin(), posting.end(), slot);
+        if (it == posting.end() || *it != slot) {
+            posting.insert(it, slot);
+        }
+    }
+}
+
+void TrigramIndex::remove(Slot slot, std::initializer_list<std::string_view> fields) {
+    std::vector<std::uint32_t> trigrams;
+    collectTrigrams(fields, trigrams);
+    for (std::uint32_t trigram : trigrams) {
+        auto postingIt = postings_.find(trigram);
+        if (postingIt == postings_.end()) {
+            continue;
+        }
+        auto& posting = postingIt->second;
+        auto it = std::lower_bound(posting.begin(), posting.end(), slot);
+        if (it != posting.end() && *it == slot) {
+            posting.erase(it);
+        }
+        if (posting.empty()) {
+            postings_.erase(postingIt);
+        }
+    }
+}
+
+void TrigramIndex::findCandidates(std::string_view foldedQuery, std::vector<Slot>& out) const {
+    out.clear();
+    std::vector<std::uint32_t> trigrams;
+    collectTrigrams({foldedQuery}, trigrams);
+
+    std::vector<const std::pmr::vector<Slot>*> lists;
+    lists.reserve(trigrams.size());
+    for (std::uint32_t trigram : trigrams) {
+        auto it = postings_.find(trigram);
+        if (it == postings_.end()) {
+            return;
+        }
+        lists.push_back(&it->second);
+    }
+    if (lists.empty()) {
+        return;
+    }
+
+    // Intersect starting from the rarest trigram; each further list is
+    // probed with a forward-only binary search
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    out.assign(lists.front()->begin(), lists.front()->end());
+    for (std::size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+        auto from = lists[i]->begin();
+        auto last = lists[i]->end();
+        std::size_t kept = 0;
+        for (Slot slot : out) {
+            from = std::lower_bound(from, last, slot);
+            if (from == last) {
+                break;
+            }
+            if (*from == slot) {
+                out[kept++] = slot;
+            }
+        }
+        out.resize(kept);
+    }
+}
+
+void TrigramIndex::fold(std::string_view text, std::string& out) {
+    out.resize(text.size());
+    std::transform(text.begin(), text.end(), out.begin(), [](char c) { return static_cast<char>(foldByte(c)); });
+}
+
+bool TrigramIndex::containsFolded(std::string_view text, std::string_view foldedQuery, std::string& buffer) {
+    fold(text, buffer);
+    return buffer.find(foldedQuery) != std::string::npos;
+}
+
+void TrigramIndex::collectTrigrams(std::initializer_list<std::string_view> fields,
+                                   std::vector<std::uint32_t>& out) {
+    out.clear();
+    for (std::string_view field : fields) {
+        for (std::size_t i = 0; i + 3 <= field.size(); ++i) {
+            out.push_back(trigramAt(field, i));
+        }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+} // namespace imagined
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace imagined {
+
+// Inverted index from case-folded (ASCII) byte trigrams to the sorted slots
+// whose text contains them. Several fields can be indexed under one slot;
+// trigrams never span two fields.
+class TrigramIndex {
+public:
+    using Slot = std::uint32_t;
+
+    // Queries shorter than this have no trigram and must be answered by a scan
+    static constexpr std::size_t kMinQueryLength = 3;
+
+    explicit TrigramIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : postings_(resource) {}
+
+    void add(Slot slot, std::initializer_list<std::string_view> fields);
+    void remove(Slot slot, std::initializer_list<std::string_view> fields);
+
+    // Replaces `out` with the slots holding every trigram of `foldedQuery`,
+    // ascending. This is a superset of the real matches, so callers verify.
+    void findCandidates(std::string_view foldedQuery, std::vector<Slot>& out) const;
+
+    static void fold(std::string_view text, std::string& out);
+    // Substring test of `foldedQuery` in `text`, folding into `buffer`
+    static bool containsFolded(std::string_view text, std::string_view foldedQuery, std::string& buffer);
+
+private:
+    std::pmr::unordered_map<std::uint32_t, std::pmr::vector<Slot>> postings_;
+
+    static void collectTrigrams(std::initializer_list<std::string_view> fields,
+                                std::vector<std::uint32_t>& out);
+};
+
+} // namespace imagined
@@ -0,0 +1,80 @@
+#include "UtilizationHistory.hpp"
+#include <algorithm>
+
+namespace imagined {
+
+UtilizationHistory::Bucket UtilizationHistory::bucketOf(const TimePoint& time) {
+    Duration::rep ticks = time.time_since_epoch().count();
+    Duration::rep width = kBucketWidth.count();
+    // Floor division, so times before the epoch land in negative buckets
+    return ticks >= 0 ? ticks / width : -((-ticks + width - 1) / width);
+}
+
+UtilizationHistory::TimePoint UtilizationHistory::bucketStart(Bucket bucket) {
+    return TimePoint(kBucketWidth * bucket);
+}
+
+void UtilizationHistory::add(const TimePoint& start, const TimePoint& end) {
+    addSpan(start, end, true);
+}
+
+void UtilizationHistory::remove(const TimePoint& start, const TimePoint& end) {
+    addSpan(start, end, false);
+}
+
+void UtilizationHistory::addSpan(const TimePoint& start, const TimePoint& end, bool booked) {
+    if (!(start < end)) {
+        return;
+    }
+    Bucket last = bucketOf(end - Duration(1));
+    auto it = std::lower_bound(buckets_.begin(), buckets_.end(), bucketOf(start),
+                               [](const Entry& entry, Bucket bucket) { return entry.bucket < bucket; });
+    for (Bucket bucket = bucketOf(start); bucket <= last; ++bucket) {
+        TimePoint from = std::max(start, bucketStart(bucket));
+        TimePoint to = std::min(end, bucketStart(bucket + 1));
+        Duration span = to - from;
+
+        while (it != buckets_.end() && it->bucket < bucket) {
+            ++it;
+        }
+        if (it == buckets_.end() || it->bucket != bucket) {
+            if (!booked) {
+                continue;
+            }
+            it = buckets_.insert(it, Entry{bucket, Duration::zero()});
+        }
+        it->booked += booked ? span : -span;
+        if (it->booked <= Duration::zero()) {
+            it = buckets_.erase(it);
+        }
+    }
+}
+
+UtilizationHistory::Duration UtilizationHistory::bookedIn(Bucket first, Bucket last) const {
+    auto it = std::lower_bound(buckets_.begin(), buckets_.end(), first,
+                               [](const Entry& entry, Bucket bucket) { return entry.bucket < bucket; });
+    Duration total = Duration::zero();
+    for (; it != buckets_.end() && it->bucket < last; ++it) {
+        total += it->booked;
+    }
+    return total;
+}
+
+UtilizationHistory::Duration UtilizationHistory::bookedWithin(const TimePoint& from, const TimePoint& to) const {
+    if (!(from < to)) {
+        return Duration::zero();
+    }
+    Bucket last = bucketOf(to - Duration(1));
+    auto it = std::lower_bound(buckets_.begin(), buckets_.end(), bucketOf(from),
+                               [](const Entry& entry, Bucket bucket) { return entry.bucket < bucket; });
+    double total = 0.0;
+    for (; it != buckets_.end() && it->bucket <= last; ++it) {
+        TimePoint start = std::max(from, bucketStart(it->bucket));
+        TimePoint end = std::min(to, bucketStart(it->bucket + 1));
+        double share = std::chrono::duration<double>(end - start) / std::chrono::duration<double>(kBucketWidth);
+        total += static_cast<double>(it->booked.count()) * share;
+    }
+    return Duration(static_cast<Duration::rep>(total));
+}
+
+} // namespace imagined
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace imagined {
+
+// Booked time of one resource accumulated in fixed one-day buckets, kept
+// sparse and ordered by bucket. Unlike the booking calendar it keeps the
+// time a resource actually served after its booking is released, so it can
+// answer utilization over past windows as well as future ones.
+class UtilizationHistory {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+    using Duration = std::chrono::system_clock::duration;
+    using Bucket = std::int64_t;  // Days since the epoch
+
+    static constexpr Duration kBucketWidth = std::chrono::hours(24);
+
+    explicit UtilizationHistory(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : buckets_(resource) {}
+
+    static Bucket bucketOf(const TimePoint& time);
+    static TimePoint bucketStart(Bucket bucket);
+
+    // Records [start, end) as booked, or takes it back
+    void add(const TimePoint& start, const TimePoint& end);
+    void remove(const TimePoint& start, const TimePoint& end);
+
+    // Booked time in the whole buckets [first, last)
+    Duration bookedIn(Bucket first, Bucket last) const;
+    // Booked time within [from, to); buckets cut by the window count in
+    // proportion to the part inside it
+    Duration bookedWithin(const TimePoint& from, const TimePoint& to) const;
+
+    bool empty() const { return buckets_.empty(); }
+
+private:
+    struct Entry {
+        Bucket bucket;
+        Duration booked;
+    };
+
+    std::pmr::vector<Entry> buckets_;  // Ascending; buckets that drop to zero are erased
+
+    void addSpan(const TimePoint& start, const TimePoint& end, bool booked);
+};
+
+} // namespace imagined
@@ -10,7 +10,7 @@ void printProject(const Project& project) {
     std::cout << "Project ID: " << project.id << std::endl;
     std::cout << "Name: " << project.name << std::endl;
     std::cout << "Status: " << static_cast<int>(project.status) << std::endl;
-    std::cout << "Type: " << static_cast<int>(project.type) << std::endl;
+    std::cout << "Type: " << projectTypeName(project.type) << std::endl;
     std::cout << "Budget: $" << std::fixed << std::setprecision(2) << project.budget << std::endl;
     std::cout << "Team Size: " << project.assignedTeamMembers.size() << std::endl;
     std::cout << "------------------------" << std::endl;
@@ -66,10 +66,10 @@ int main() {
     // Create resource allocation request
     AllocationRequest request;
     request.projectId = projectId;
-    request.requiredSkills = {"1"}; // WEB_DESIGN
+    request.requiredSkills = {"WEB_DESIGN"};
     request.requiredTeamSize = 1;
     request.startDate = std::chrono::system_clock::now();
-    request.endDate = request.startDate + std::chrono::hours(24 * 30); // 30 days
+    request.endDate = request.startDate + std::chrono::hours(24 * 14); // 14 days
     request.budget = 50000.0;
 
     // Allocate resources
@@ -0,0 +1,154 @@
+#include "AllocationService.hpp"
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+namespace imagined {
+
+AllocationService::AllocationService(ResourceAllocator& allocator)
+    : AllocationService(allocator, Options()) {}
+
+AllocationService::AllocationService(ResourceAllocator& allocator, Options options)
+    : allocator_(allocator), options_(options) {
+    if (options_.workers == 0) {
+        options_.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    options_.queueCapacity = std::max<std::size_t>(1, options_.queueCapacity);
+    workers_.reserve(options_.workers);
+    for (std::size_t i = 0; i < options_.workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&AllocationService::workerLoop, this, i);
+    }
+}
+
+AllocationService::~AllocationService() {
+    shutdown();
+}
+
+std::future<AllocationResult> AllocationService::submitAllocation(AllocationRequest request) {
+    auto promise = std::make_shared<std::promise<AllocationResult>>();
+    std::future<AllocationResult> future = promise->get_future();
+    bool accepted = submitAllocation(std::move(request), [promise](AllocationResult result) {
+        promise->set_value(std::move(result));
+    });
+    if (!accepted) {
+        AllocationResult refused;
+        refused.success = false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        refused.message = stopping_ ? "Allocation service stopped" : "Allocation queue full";
+        promise->set_value(std::move(refused));
+    }
+    return future;
+}
+
+bool AllocationService::submitAllocation(AllocationRequest request, Completion onComplete) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (options_.backpressure == Backpressure::BLOCK) {
+        notFull_.wait(lock, [this] { return stopping_ || pending_ < options_.queueCapacity; });
+    }
+    if (stopping_ || pending_ >= options_.queueCapacity) {
+        return false;
+    }
+    ++pending_;
+    auto& group = groups_[request.projectId];
+    bool schedule = group == nullptr;
+    if (schedule) {
+        group = std::make_unique<Group>();
+        group->projectId = request.projectId;
+    }
+    group->requests.push_back(Pending{std::move(request), std::move(onComplete)});
+    if (schedule) {
+        Worker& worker = *workers_[nextWorker_++ % workers_.size()];
+        std::lock_guard<std::mutex> workerLock(worker.mutex);
+        worker.groups.push_back(group.get());
+        readyGroups_.fetch_add(1, std::memory_order_relaxed);
+        workReady_.notify_one();
+    }
+    return true;
+}
+
+void AllocationService::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    notFull_.notify_all();
+    workReady_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::size_t AllocationService::pendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_;
+}
+
+void AllocationService::workerLoop(std::size_t self) {
+    while (true) {
+        if (Group* group = takeGroup(self)) {
+            runGroup(*group);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        workReady_.wait(lock, [this] {
+            return readyGroups_.load(std::memory_order_relaxed) > 0 || (stopping_ && pending_ == 0);
+        });
+        if (readyGroups_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+AllocationService::Group* AllocationService::takeGroup(std::size_t self) {
+    for (std::size_t k = 0; k < workers_.size(); ++k) {
+        Worker& worker = *workers_[(self + k) % workers_.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.groups.empty()) {
+            continue;
+        }
+        Group* group;
+        if (k == 0) {
+            group = worker.groups.front();
+            worker.groups.pop_front();
+        } else {
+            group = worker.groups.back();
+            worker.groups.pop_back();
+        }
+        readyGroups_.fetch_sub(1, std::memory_order_relaxed);
+        return group;
+    }
+    return nullptr;
+}
+
+void AllocationService::runGroup(Group& group) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!group.requests.empty()) {
+        Pending next = std::move(group.requests.front());
+        group.requests.pop_front();
+        lock.unlock();
+
+        AllocationResult result;
+        try {
+            result = allocator_.allocateResources(next.request);
+        } catch (const std::exception& e) {
+            result = AllocationResult{false, {}, {}, e.what()};
+        }
+        next.onComplete(std::move(result));
+
+        lock.lock();
+        --pending_;
+        notFull_.notify_one();
+    }
+    // Erasing destroys the group; a later request for the project starts a new one
+    groups_.erase(group.projectId);
+    if (stopping_ && pending_ == 0) {
+        workReady_.notify_all();
+    }
+}
+
+} // namespace imagined
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "core/ResourceAllocator.hpp"
+
+namespace imagined {
+
+// Asynchronous front door to ResourceAllocator::allocateResources: callers
+// hand a request over and get a future, or a completion callback, instead of
+// running the allocation on their own thread.
+//
+// Accepted requests are grouped by project. A project's group is queued on
+// one worker and its requests run back to back in submission order, so
+// requests for the same project never race each other's optimistic commits,
+// and a request arriving while its project is queued or running just joins
+// the group. Groups are dealt round-robin onto per-worker deques; a worker
+// takes from the front of its own deque and, when that is empty, steals from
+// the back of the others.
+//
+// At most queueCapacity requests are accepted and unfinished at a time. A
+// submit beyond that waits for room (BLOCK) or is refused (REJECT).
+class AllocationService {
+public:
+    enum class Backpressure {
+        BLOCK,
+        REJECT
+    };
+
+    struct Options {
+        std::size_t workers = 0;           // Zero for one per hardware thread
+        std::size_t queueCapacity = 1024;  // Requests accepted and not finished yet
+        Backpressure backpressure = Backpressure::BLOCK;
+    };
+
+    // Runs on a worker thread; it must not block for long or throw
+    using Completion = std::function<void(AllocationResult)>;
+
+    explicit AllocationService(ResourceAllocator& allocator);
+    AllocationService(ResourceAllocator& allocator, Options options);
+    ~AllocationService();
+
+    AllocationService(const AllocationService&) = delete;
+    AllocationService& operator=(const AllocationService&) = delete;
+
+    // A refused request yields an unsuccessful result right away, with the
+    // message "Allocation queue full" or "Allocation service stopped"
+    std::future<AllocationResult> submitAllocation(AllocationRequest request);
+    // Returns false, without calling onComplete, if the request is refused
+    bool submitAllocation(AllocationRequest request, Completion onComplete);
+
+    // Stops accepting requests, finishes the accepted ones and joins the
+    // workers. Called by the destructor.
+    void shutdown();
+
+    std::size_t pendingCount() const;
+    std::size_t workerCount() const { return workers_.size(); }
+
+private:
+    struct Pending {
+        AllocationRequest request;
+        Completion onComplete;
+    };
+
+    struct Group {
+        std::string projectId;
+        std::deque<Pending> requests;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Group*> groups;
+        std::thread thread;
+    };
+
+    ResourceAllocator& allocator_;
+    Options options_;
+
+    // Guards groups_, their requests, pending_ and stopping_; taken before a
+    // worker's deque mutex, never while running an allocation
+    mutable std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable workReady_;
+    std::unordered_map<std::string, std::unique_ptr<Group>> groups_;
+    std::size_t pending_ = 0;
+    std::size_t nextWorker_ = 0;
+    bool stopping_ = false;
+    // Groups sitting in a worker deque; raised under mutex_
+    std::atomic<std::size_t> readyGroups_{0};
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    void workerLoop(std::size_t self);
+    Group* takeGroup(std::size_t self);
+    void runGroup(Group& group);
+};
+
+} // namespace imagined
@@ -0,0 +1,219 @@
+#include "BinaryCodec.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace imagined {
+
+namespace {
+
+std::array<std::uint32_t, 256> makeCrcTable() {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t value = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+        }
+        table[i] = value;
+    }
+    return table;
+}
+
+} // namespace
+
+void BinaryWriter::u32(std::uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        u8(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+void BinaryWriter::u64(std::uint64_t value) {
+    for (int shift = 0; shift < 64; shift += 8) {
+        u8(static_cast<std::uint8_t>(value >> shift));
+    }
+}
+
+void BinaryWriter::f64(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    u64(bits);
+}
+
+void BinaryWriter::str(const std::string& value) {
+    u32(static_cast<std::uint32_t>(value.size()));
+    buffer_.append(value);
+}
+
+void BinaryWriter::time(const std::chrono::system_clock::time_point& value) {
+    auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(value.time_since_epoch()).count();
+    u64(static_cast<std::uint64_t>(nanoseconds));
+}
+
+void BinaryWriter::strings(const std::vector<std::string>& values) {
+    u32(static_cast<std::uint32_t>(values.size()));
+    for (const auto& value : values) {
+        str(value);
+    }
+}
+
+const char* BinaryReader::take(std::size_t bytes) {
+    if (size_ - offset_ < bytes) {
+        throw std::runtime_error("Truncated record");
+    }
+    const char* at = data_ + offset_;
+    offset_ += bytes;
+    return at;
+}
+
+std::uint8_t BinaryReader::u8() {
+    return static_cast<std::uint8_t>(*take(1));
+}
+
+std::uint32_t BinaryReader::u32() {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(take(4));
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+std::uint64_t BinaryReader::u64() {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(take(8));
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+double BinaryReader::f64() {
+    std::uint64_t bits = u64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string BinaryReader::str() {
+    std::uint32_t length = u32();
+    return std::string(take(length), length);
+}
+
+std::chrono::system_clock::time_point BinaryReader::time() {
+    auto nanoseconds = std::chrono::nanoseconds(static_cast<std::int64_t>(u64()));
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(nanoseconds));
+}
+
+std::vector<std::string> BinaryReader::strings() {
+    std::uint32_t count = u32();
+    std::vector<std::string> values;
+    values.reserve(std::min<std::size_t>(count, size_ - offset_));
+    for (std::uint32_t i = 0; i < count; ++i) {
+        values.push_back(str());
+    }
+    return values;
+}
+
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t previous) {
+    static const std::array<std::uint32_t, 256> table = makeCrcTable();
+    std::uint32_t crc = previous ^ 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void encodeProject(BinaryWriter& out, const Project& project) {
+    out.str(project.id);
+    out.str(project.name);
+    out.str(project.clientId);
+    out.u8(static_cast<std::uint8_t>(project.type));
+    out.u8(static_cast<std::uint8_t>(project.status));
+    out.time(project.deadline);
+    out.strings(project.assignedTeamMembers);
+    out.str(project.projectManager);
+    out.f64(project.budget);
+    out.str(project.description);
+}
+
+Project decodeProject(BinaryReader& in) {
+    Project project;
+    project.id = in.str();
+    project.name = in.str();
+    project.clientId = in.str();
+    project.type = static_cast<ProjectType>(in.u8());
+    project.status = static_cast<ProjectStatus>(in.u8());
+    project.deadline = in.time();
+    project.assignedTeamMembers = in.strings();
+    project.projectManager = in.str();
+    project.budget = in.f64();
+    project.description = in.str();
+    return project;
+}
+
+void encodeTalent(BinaryWriter& out, const Talent& talent) {
+    out.str(talent.id);
+    out.str(talent.name);
+    out.str(talent.email);
+    out.u32(talent.skills.mask());
+    out.u8(static_cast<std::uint8_t>(talent.experienceLevel));
+    out.strings(talent.completedProjects);
+    out.f64(talent.hourlyRate);
+    out.u8(talent.isAvailable ? 1 : 0);
+    out.str(talent.timezone);
+    out.str(talent.preferredLanguage);
+}
+
+Talent decodeTalent(BinaryReader& in) {
+    Talent talent;
+    talent.id = in.str();
+    talent.name = in.str();
+    talent.email = in.str();
+    talent.skills = SkillSet(static_cast<SkillSet::Mask>(in.u32()));
+    talent.experienceLevel = static_cast<ExperienceLevel>(in.u8());
+    talent.completedProjects = in.strings();
+    talent.hourlyRate = in.f64();
+    talent.isAvailable = in.u8() != 0;
+    talent.timezone = in.str();
+    talent.preferredLanguage = in.str();
+    return talent;
+}
+
+void encodeResource(BinaryWriter& out, const Resource& resource, const std::vector<Booking>& bookings) {
+    out.str(resource.id);
+    out.str(resource.name);
+    out.str(resource.type);
+    out.u8(resource.isAvailable ? 1 : 0);
+    out.time(resource.lastUsed);
+    out.str(resource.currentProjectId);
+    out.u32(static_cast<std::uint32_t>(bookings.size()));
+    for (const auto& booking : bookings) {
+        out.time(booking.startDate);
+        out.time(booking.endDate);
+        out.str(booking.projectId);
+    }
+}
+
+Resource decodeResource(BinaryReader& in, std::vector<Booking>& bookings) {
+    Resource resource;
+    resource.id = in.str();
+    resource.name = in.str();
+    resource.type = in.str();
+    resource.isAvailable = in.u8() != 0;
+    resource.lastUsed = in.time();
+    resource.currentProjectId = in.str();
+    std::uint32_t count = in.u32();
+    bookings.clear();
+    for (std::uint32_t i = 0; i < count; ++i) {
+        Booking booking;
+        booking.startDate = in.time();
+        booking.endDate = in.time();
+        booking.projectId = in.str();
+        bookings.push_back(std::move(booking));
+    }
+    return resource;
+}
+
+} // namespace imagined
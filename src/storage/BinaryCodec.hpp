@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/BookingCalendar.hpp"
+#include "core/ProjectManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "core/TalentManager.hpp"
+
+namespace imagined {
+
+// Little-endian append-only encoder for log records and snapshots
+class BinaryWriter {
+public:
+    void u8(std::uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+    void u32(std::uint32_t value);
+    void u64(std::uint64_t value);
+    void f64(double value);
+    void str(const std::string& value);
+    void time(const std::chrono::system_clock::time_point& value);
+    void strings(const std::vector<std::string>& values);
+
+    const std::string& data() const { return buffer_; }
+    std::string& data() { return buffer_; }
+    void clear() { buffer_.clear(); }
+
+private:
+    std::string buffer_;
+};
+
+// Bounds-checked decoder; throws std::runtime_error on truncated input
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size) : data_(data), size_(size) {}
+
+    std::uint8_t u8();
+    std::uint32_t u32();
+    std::uint64_t u64();
+    double f64();
+    std::string str();
+    std::chrono::system_clock::time_point time();
+    std::vector<std::string> strings();
+    // Returns the next `size` bytes and moves past them
+    const char* bytes(std::size_t size) { return take(size); }
+
+    bool atEnd() const { return offset_ == size_; }
+    std::size_t offset() const { return offset_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+
+    const char* take(std::size_t bytes);
+};
+
+// CRC-32 (IEEE); pass the previous result to continue over several buffers
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t previous = 0);
+
+void encodeProject(BinaryWriter& out, const Project& project);
+Project decodeProject(BinaryReader& in);
+void encodeTalent(BinaryWriter& out, const Talent& talent);
+Talent decodeTalent(BinaryReader& in);
+void encodeResource(BinaryWriter& out, const Resource& resource, const std::vector<Booking>& bookings);
+Resource decodeResource(BinaryReader& in, std::vector<Booking>& bookings);
+
+} // namespace imagined
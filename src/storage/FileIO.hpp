@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace imagined {
+
+// Writes all of `data`, retrying short writes and EINTR
+bool writeFully(int fd, const char* data, std::size_t size);
+
+// Makes entries created or renamed in `directory` durable
+void syncDirectory(const std::string& directory);
+
+// Replaces `path` atomically: `fill` writes the new content to a temporary
+// file beside it, which is synced and renamed over `path`. A crash leaves
+// either the old or the new file.
+bool replaceFile(const std::string& path, const std::function<bool(int fd)>& fill);
+
+} // namespace imagined
@@ -0,0 +1,541 @@
+#include "MappedSnapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BinaryCodec.hpp"
+#include "FileIO.hpp"
+
+namespace imagined {
+
+namespace {
+
+constexpr char kMagic[8] = {'I', 'M', 'M', 'A', 'P', '\0', '\0', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kByteOrderTag = 0x01020304;
+
+enum Section : std::size_t {
+    STRINGS,
+    STRING_REFS,
+    PROJECTS,
+    PROJECT_TABLE,
+    PROJECTS_BY_STATUS,
+    PROJECT_STATUS_STARTS,
+    PROJECTS_BY_TYPE,
+    PROJECT_TYPE_STARTS,
+    TALENTS,
+    TALENT_TABLE,
+    TALENTS_BY_LEVEL,
+    TALENT_LEVEL_STARTS,
+    SECTION_COUNT
+};
+
+struct SectionEntry {
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t walSequence;
+    std::uint64_t fileBytes;
+    std::uint32_t bodyChecksum;  // CRC-32 of everything after the header
+    std::uint32_t reserved;
+    SectionEntry sections[SECTION_COUNT];
+};
+
+static_assert(sizeof(MappedProjectRecord) == 72, "Project record layout changed");
+static_assert(sizeof(MappedTalentRecord) == 64, "Talent record layout changed");
+static_assert(sizeof(FileHeader) % 8 == 0, "Header must keep sections aligned");
+static_assert(std::is_trivially_copyable<MappedProjectRecord>::value &&
+              std::is_trivially_copyable<MappedTalentRecord>::value,
+              "Records are read in place");
+
+// FNV-1a; unlike std::hash it is the same in every process
+std::uint64_t hashId(std::string_view id) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : id) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::int64_t toNanoseconds(const std::chrono::system_clock::time_point& value) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(value.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNanoseconds(std::int64_t value) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(value)));
+}
+
+// Deduplicated string section plus the string-ref section for lists
+class StringTable {
+public:
+    MappedStringRef add(const std::string& value) {
+        if (value.empty()) {
+            return MappedStringRef{0, 0};
+        }
+        auto [it, inserted] = interned_.try_emplace(value, MappedStringRef{0, 0});
+        if (inserted) {
+            it->second = MappedStringRef{static_cast<std::uint32_t>(text_.size()),
+                                         static_cast<std::uint32_t>(value.size())};
+            text_ += value;
+        }
+        return it->second;
+    }
+
+    MappedListRef addList(const std::vector<std::string>& values) {
+        MappedListRef list{static_cast<std::uint32_t>(refs_.size()), static_cast<std::uint32_t>(values.size())};
+        for (const auto& value : values) {
+            refs_.push_back(add(value));
+        }
+        return list;
+    }
+
+    // Offsets are 32-bit
+    bool fits() const { return text_.size() <= UINT32_MAX && refs_.size() <= UINT32_MAX; }
+    const std::string& text() const { return text_; }
+    const std::vector<MappedStringRef>& refs() const { return refs_; }
+
+private:
+    std::string text_;
+    std::vector<MappedStringRef> refs_;
+    std::unordered_map<std::string, MappedStringRef> interned_;
+};
+
+// Open-addressing table of record index + 1, at most half full
+template <typename Entity>
+std::vector<std::uint32_t> buildIdTable(const std::vector<Entity>& entities) {
+    std::size_t size = 1;
+    while (size < entities.size() * 2) {
+        size <<= 1;
+    }
+    std::vector<std::uint32_t> table(size, 0);
+    for (std::size_t i = 0; i < entities.size(); ++i) {
+        std::size_t pos = hashId(entities[i].id) & (size - 1);
+        while (table[pos] != 0) {
+            pos = (pos + 1) & (size - 1);
+        }
+        table[pos] = static_cast<std::uint32_t>(i + 1);
+    }
+    return table;
+}
+
+// Orders record indexes by bucket, then by `less` inside a bucket, and
+// returns the start of every bucket plus the end
+template <typename Entity, typename Bucket, typename Less>
+std::vector<std::uint32_t> buildOrdering(const std::vector<Entity>& entities, std::size_t bucketCount,
+                                         Bucket bucket, Less less, std::vector<std::uint32_t>& order) {
+    order.resize(entities.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        std::size_t bucketA = bucket(entities[a]);
+        std::size_t bucketB = bucket(entities[b]);
+        if (bucketA != bucketB) {
+            return bucketA < bucketB;
+        }
+        return less(entities[a], entities[b]);
+    });
+
+    std::vector<std::uint32_t> starts(bucketCount + 1, 0);
+    for (const auto& entity : entities) {
+        ++starts[bucket(entity) + 1];
+    }
+    std::partial_sum(starts.begin(), starts.end(), starts.begin());
+    return starts;
+}
+
+} // namespace
+
+std::string_view ProjectView::id() const { return snapshot_->text(record_->id); }
+std::string_view ProjectView::name() const { return snapshot_->text(record_->name); }
+std::string_view ProjectView::clientId() const { return snapshot_->text(record_->clientId); }
+std::string_view ProjectView::projectManager() const { return snapshot_->text(record_->projectManager); }
+std::string_view ProjectView::description() const { return snapshot_->text(record_->description); }
+
+std::chrono::system_clock::time_point ProjectView::deadline() const {
+    return fromNanoseconds(record_->deadline);
+}
+
+std::string_view ProjectView::teamMember(std::size_t index) const {
+    return snapshot_->listItem(record_->assignedTeamMembers, index);
+}
+
+Project ProjectView::toProject() const {
+    Project project;
+    project.id = std::string(id());
+    project.name = std::string(name());
+    project.clientId = std::string(clientId());
+    project.type = type();
+    project.status = status();
+    project.deadline = deadline();
+    for (std::size_t i = 0; i < teamSize(); ++i) {
+        project.assignedTeamMembers.emplace_back(teamMember(i));
+    }
+    project.projectManager = std::string(projectManager());
+    project.budget = budget();
+    project.description = std::string(description());
+    return project;
+}
+
+std::string_view TalentView::id() const { return snapshot_->text(record_->id); }
+std::string_view TalentView::name() const { return snapshot_->text(record_->name); }
+std::string_view TalentView::email() const { return snapshot_->text(record_->email); }
+std::string_view TalentView::timezone() const { return snapshot_->text(record_->timezone); }
+std::string_view TalentView::preferredLanguage() const { return snapshot_->text(record_->preferredLanguage); }
+
+std::string_view TalentView::completedProject(std::size_t index) const {
+    return snapshot_->listItem(record_->completedProjects, index);
+}
+
+Talent TalentView::toTalent() const {
+    Talent talent;
+    talent.id = std::string(id());
+    talent.name = std::string(name());
+    talent.email = std::string(email());
+    talent.skills = skills();
+    talent.experienceLevel = experienceLevel();
+    for (std::size_t i = 0; i < completedProjectCount(); ++i) {
+        talent.completedProjects.emplace_back(completedProject(i));
+    }
+    talent.hourlyRate = hourlyRate();
+    talent.isAvailable = isAvailable();
+    talent.timezone = std::string(timezone());
+    talent.preferredLanguage = std::string(preferredLanguage());
+    return talent;
+}
+
+MappedSnapshot::MappedSnapshot(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Snapshot not found");
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Invalid snapshot");
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map snapshot");
+    }
+    data_ = static_cast<const char*>(mapping);
+
+    auto fail = [&](const char* message) {
+        ::munmap(const_cast<char*>(data_), size_);
+        throw std::runtime_error(message);
+    };
+    const auto* header = reinterpret_cast<const FileHeader*>(data_);
+    if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->fileBytes != size_) {
+        fail("Invalid snapshot");
+    }
+    if (header->byteOrder != kByteOrderTag) {
+        fail("Snapshot byte order mismatch");
+    }
+    if (header->version != kVersion) {
+        fail("Unsupported snapshot version");
+    }
+
+    // Locates a section and returns its element count, or fails
+    std::size_t count = 0;
+    auto section = [&](Section id, std::size_t elementSize) -> const void* {
+        const SectionEntry& entry = header->sections[id];
+        if (entry.offset % 8 != 0 || entry.offset > size_ || entry.bytes > size_ - entry.offset ||
+            entry.bytes % elementSize != 0) {
+            fail("Invalid snapshot");
+        }
+        count = static_cast<std::size_t>(entry.bytes / elementSize);
+        return data_ + entry.offset;
+    };
+    auto table = [&](Section id, std::size_t& mask) {
+        const auto* slots = static_cast<const std::uint32_t*>(section(id, sizeof(std::uint32_t)));
+        if (count == 0 || (count & (count - 1)) != 0) {
+            fail("Invalid snapshot");
+        }
+        mask = count - 1;
+        return slots;
+    };
+    auto ordering = [&](Section id, std::size_t expected) {
+        const auto* order = static_cast<const std::uint32_t*>(section(id, sizeof(std::uint32_t)));
+        if (count != expected) {
+            fail("Invalid snapshot");
+        }
+        return order;
+    };
+    auto starts = [&](Section id, std::size_t bucketCount, std::size_t total) {
+        const auto* bounds = static_cast<const std::uint32_t*>(section(id, sizeof(std::uint32_t)));
+        if (count != bucketCount + 1 || bounds[0] != 0 || bounds[bucketCount] != total ||
+            !std::is_sorted(bounds, bounds + count)) {
+            fail("Invalid snapshot");
+        }
+        return bounds;
+    };
+
+    strings_ = static_cast<const char*>(section(STRINGS, 1));
+    stringRefs_ = static_cast<const MappedStringRef*>(section(STRING_REFS, sizeof(MappedStringRef)));
+    projects_ = static_cast<const MappedProjectRecord*>(section(PROJECTS, sizeof(MappedProjectRecord)));
+    projectCount_ = count;
+    projectTable_ = table(PROJECT_TABLE, projectTableMask_);
+    projectsByStatus_ = ordering(PROJECTS_BY_STATUS, projectCount_);
+    projectStatusStarts_ = starts(PROJECT_STATUS_STARTS, kProjectStatusCount, projectCount_);
+    projectsByType_ = ordering(PROJECTS_BY_TYPE, projectCount_);
+    projectTypeStarts_ = starts(PROJECT_TYPE_STARTS, kProjectTypeCount, projectCount_);
+    talents_ = static_cast<const MappedTalentRecord*>(section(TALENTS, sizeof(MappedTalentRecord)));
+    talentCount_ = count;
+    talentTable_ = table(TALENT_TABLE, talentTableMask_);
+    talentsByLevel_ = ordering(TALENTS_BY_LEVEL, talentCount_);
+    talentLevelStarts_ = starts(TALENT_LEVEL_STARTS, kExperienceLevelCount, talentCount_);
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    ::munmap(const_cast<char*>(data_), size_);
+}
+
+std::uint64_t MappedSnapshot::walSequence() const {
+    return reinterpret_cast<const FileHeader*>(data_)->walSequence;
+}
+
+bool MappedSnapshot::verify() const {
+    const auto* header = reinterpret_cast<const FileHeader*>(data_);
+    return header->bodyChecksum == crc32(data_ + sizeof(FileHeader), size_ - sizeof(FileHeader));
+}
+
+template <typename Record>
+const Record* MappedSnapshot::lookup(std::string_view id, const Record* records, const std::uint32_t* table,
+                                     std::size_t mask) const {
+    std::size_t pos = hashId(id) & mask;
+    for (std::size_t probes = 0; probes <= mask; ++probes, pos = (pos + 1) & mask) {
+        std::uint32_t entry = table[pos];
+        if (entry == 0) {
+            break;
+        }
+        const Record& record = records[entry - 1];
+        if (text(record.id) == id) {
+            return &record;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<ProjectView> MappedSnapshot::findProject(std::string_view projectId) const {
+    const auto* record = lookup(projectId, projects_, projectTable_, projectTableMask_);
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    return ProjectView(*this, *record);
+}
+
+Project MappedSnapshot::getProject(const std::string& projectId) const {
+    auto project = findProject(projectId);
+    if (!project) {
+        throw std::runtime_error("Project not found");
+    }
+    return project->toProject();
+}
+
+void MappedSnapshot::forEachProject(const std::function<bool(const ProjectView&)>& visitor) const {
+    for (std::size_t i = 0; i < projectCount_; ++i) {
+        if (!visitor(ProjectView(*this, projects_[i]))) {
+            return;
+        }
+    }
+}
+
+void MappedSnapshot::visitProjects(const std::uint32_t* order, const std::uint32_t* starts, std::size_t bucket,
+                                   const std::function<bool(const ProjectView&)>& visitor) const {
+    for (std::uint32_t i = starts[bucket]; i < starts[bucket + 1]; ++i) {
+        if (!visitor(ProjectView(*this, projects_[order[i]]))) {
+            return;
+        }
+    }
+}
+
+void MappedSnapshot::forEachProjectWithStatus(ProjectStatus status,
+                                              const std::function<bool(const ProjectView&)>& visitor) const {
+    visitProjects(projectsByStatus_, projectStatusStarts_, static_cast<std::size_t>(status), visitor);
+}
+
+void MappedSnapshot::forEachProjectOfType(ProjectType type,
+                                          const std::function<bool(const ProjectView&)>& visitor) const {
+    visitProjects(projectsByType_, projectTypeStarts_, static_cast<std::size_t>(type), visitor);
+}
+
+std::vector<Project> MappedSnapshot::getProjectsByStatus(ProjectStatus status) const {
+    std::vector<Project> result;
+    forEachProjectWithStatus(status, [&](const ProjectView& project) {
+        result.push_back(project.toProject());
+        return true;
+    });
+    return result;
+}
+
+std::optional<TalentView> MappedSnapshot::findTalent(std::string_view talentId) const {
+    const auto* record = lookup(talentId, talents_, talentTable_, talentTableMask_);
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    return TalentView(*this, *record);
+}
+
+Talent MappedSnapshot::getTalent(const std::string& talentId) const {
+    auto talent = findTalent(talentId);
+    if (!talent) {
+        throw std::runtime_error("Talent not found");
+    }
+    return talent->toTalent();
+}
+
+void MappedSnapshot::forEachTalent(const TalentFilter& filter,
+                                   const std::function<bool(const TalentView&)>& visitor) const {
+    std::size_t firstLevel = 0;
+    std::size_t lastLevel = kExperienceLevelCount;
+    if (filter.experienceLevel) {
+        firstLevel = static_cast<std::size_t>(*filter.experienceLevel);
+        lastLevel = firstLevel + 1;
+    }
+    for (std::size_t level = firstLevel; level < lastLevel; ++level) {
+        const std::uint32_t* end = talentsByLevel_ + talentLevelStarts_[level + 1];
+        const std::uint32_t* it = std::lower_bound(
+            talentsByLevel_ + talentLevelStarts_[level], end, filter.minRate,
+            [&](std::uint32_t index, double rate) { return talents_[index].hourlyRate < rate; });
+        for (; it != end && talents_[*it].hourlyRate <= filter.maxRate; ++it) {
+            const MappedTalentRecord& record = talents_[*it];
+            if (!SkillSet(record.skills).containsAll(filter.requiredSkills) ||
+                (filter.availableOnly && record.isAvailable == 0) ||
+                (filter.timezone && text(record.timezone) != filter.timezone->str()) ||
+                (filter.preferredLanguage && text(record.preferredLanguage) != filter.preferredLanguage->str())) {
+                continue;
+            }
+            if (!visitor(TalentView(*this, record))) {
+                return;
+            }
+        }
+    }
+}
+
+std::vector<Talent> MappedSnapshot::findTalents(const TalentFilter& filter) const {
+    std::vector<Talent> result;
+    forEachTalent(filter, [&](const TalentView& talent) {
+        result.push_back(talent.toTalent());
+        return true;
+    });
+    return result;
+}
+
+bool writeMappedSnapshot(const std::string& path, std::uint64_t walSequence,
+                         const ProjectManager& projects, const TalentManager& talents) {
+    std::vector<Project> projectList;
+    projects.forEachProject([&](const Project& project) {
+        projectList.push_back(project);
+        return true;
+    });
+    std::vector<Talent> talentList;
+    talents.forEachTalent(TalentFilter{}, [&](const Talent& talent) {
+        talentList.push_back(talent);
+        return true;
+    });
+
+    StringTable strings;
+    std::vector<MappedProjectRecord> projectRecords(projectList.size());
+    for (std::size_t i = 0; i < projectList.size(); ++i) {
+        const Project& project = projectList[i];
+        MappedProjectRecord& record = projectRecords[i];
+        record = MappedProjectRecord{};
+        record.id = strings.add(project.id);
+        record.name = strings.add(project.name);
+        record.clientId = strings.add(project.clientId);
+        record.projectManager = strings.add(project.projectManager);
+        record.description = strings.add(project.description);
+        record.assignedTeamMembers = strings.addList(project.assignedTeamMembers);
+        record.deadline = toNanoseconds(project.deadline);
+        record.budget = project.budget;
+        record.type = static_cast<std::uint8_t>(project.type);
+        record.status = static_cast<std::uint8_t>(project.status);
+    }
+    std::vector<MappedTalentRecord> talentRecords(talentList.size());
+    for (std::size_t i = 0; i < talentList.size(); ++i) {
+        const Talent& talent = talentList[i];
+        MappedTalentRecord& record = talentRecords[i];
+        record = MappedTalentRecord{};
+        record.id = strings.add(talent.id);
+        record.name = strings.add(talent.name);
+        record.email = strings.add(talent.email);
+        record.timezone = strings.add(talent.timezone);
+        record.preferredLanguage = strings.add(talent.preferredLanguage);
+        record.completedProjects = strings.addList(talent.completedProjects);
+        record.hourlyRate = talent.hourlyRate;
+        record.skills = talent.skills.mask();
+        record.experienceLevel = static_cast<std::uint8_t>(talent.experienceLevel);
+        record.isAvailable = talent.isAvailable ? 1 : 0;
+    }
+    if (!strings.fits()) {
+        return false;
+    }
+
+    auto byDeadline = [](const Project& a, const Project& b) { return a.deadline < b.deadline; };
+    std::vector<std::uint32_t> projectsByStatus;
+    std::vector<std::uint32_t> statusStarts = buildOrdering(
+        projectList, kProjectStatusCount,
+        [](const Project& project) { return static_cast<std::size_t>(project.status); }, byDeadline,
+        projectsByStatus);
+    std::vector<std::uint32_t> projectsByType;
+    std::vector<std::uint32_t> typeStarts = buildOrdering(
+        projectList, kProjectTypeCount,
+        [](const Project& project) { return static_cast<std::size_t>(project.type); }, byDeadline,
+        projectsByType);
+    std::vector<std::uint32_t> talentsByLevel;
+    std::vector<std::uint32_t> levelStarts = buildOrdering(
+        talentList, kExperienceLevelCount,
+        [](const Talent& talent) { return static_cast<std::size_t>(talent.experienceLevel); },
+        [](const Talent& a, const Talent& b) { return a.hourlyRate < b.hourlyRate; }, talentsByLevel);
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderTag;
+    header.walSequence = walSequence;
+
+    std::string file(sizeof(FileHeader), '\0');
+    auto append = [&](Section id, const void* data, std::size_t bytes) {
+        file.resize((file.size() + 7) & ~std::size_t(7), '\0');
+        header.sections[id] = SectionEntry{file.size(), bytes};
+        if (bytes > 0) {
+            file.append(static_cast<const char*>(data), bytes);
+        }
+    };
+    auto appendVector = [&](Section id, const auto& values) {
+        append(id, values.data(), values.size() * sizeof(values[0]));
+    };
+    append(STRINGS, strings.text().data(), strings.text().size());
+    appendVector(STRING_REFS, strings.refs());
+    appendVector(PROJECTS, projectRecords);
+    appendVector(PROJECT_TABLE, buildIdTable(projectList));
+    appendVector(PROJECTS_BY_STATUS, projectsByStatus);
+    appendVector(PROJECT_STATUS_STARTS, statusStarts);
+    appendVector(PROJECTS_BY_TYPE, projectsByType);
+    appendVector(PROJECT_TYPE_STARTS, typeStarts);
+    appendVector(TALENTS, talentRecords);
+    appendVector(TALENT_TABLE, buildIdTable(talentList));
+    appendVector(TALENTS_BY_LEVEL, talentsByLevel);
+    appendVector(TALENT_LEVEL_STARTS, levelStarts);
+
+    header.fileBytes = file.size();
+    header.bodyChecksum = crc32(file.data() + sizeof(FileHeader), file.size() - sizeof(FileHeader));
+    std::memcpy(&file[0], &header, sizeof(FileHeader));
+
+    return replaceFile(path, [&](int fd) { return writeFully(fd, file.data(), file.size()); });
+}
+
+} // namespace imagined
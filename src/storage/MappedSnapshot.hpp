@@ -0,0 +1,194 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "core/ProjectManager.hpp"
+#include "core/TalentManager.hpp"
+
+namespace imagined {
+
+// On-disk layout. Every section starts 8-byte aligned and is read in place
+// through these structs, so the file is only valid on hosts with the same
+// byte order (checked at open) as the writer.
+struct MappedStringRef {
+    std::uint32_t offset;  // Into the string section
+    std::uint32_t length;
+};
+
+struct MappedListRef {
+    std::uint32_t first;   // Into the string-ref section
+    std::uint32_t count;
+};
+
+struct MappedProjectRecord {
+    MappedStringRef id;
+    MappedStringRef name;
+    MappedStringRef clientId;
+    MappedStringRef projectManager;
+    MappedStringRef description;
+    MappedListRef assignedTeamMembers;
+    std::int64_t deadline;  // Nanoseconds since the epoch
+    double budget;
+    std::uint8_t type;
+    std::uint8_t status;
+    std::uint8_t reserved[6];
+};
+
+struct MappedTalentRecord {
+    MappedStringRef id;
+    MappedStringRef name;
+    MappedStringRef email;
+    MappedStringRef timezone;
+    MappedStringRef preferredLanguage;
+    MappedListRef completedProjects;
+    double hourlyRate;
+    std::uint16_t skills;
+    std::uint8_t experienceLevel;
+    std::uint8_t isAvailable;
+    std::uint8_t reserved[4];
+};
+
+class MappedSnapshot;
+
+// Zero-copy views of one record; string accessors point into the mapping
+// and stay valid as long as the snapshot does
+class ProjectView {
+public:
+    std::string_view id() const;
+    std::string_view name() const;
+    std::string_view clientId() const;
+    std::string_view projectManager() const;
+    std::string_view description() const;
+    ProjectType type() const { return static_cast<ProjectType>(record_->type); }
+    ProjectStatus status() const { return static_cast<ProjectStatus>(record_->status); }
+    std::chrono::system_clock::time_point deadline() const;
+    double budget() const { return record_->budget; }
+    std::size_t teamSize() const { return record_->assignedTeamMembers.count; }
+    std::string_view teamMember(std::size_t index) const;
+
+    Project toProject() const;
+
+private:
+    friend class MappedSnapshot;
+    ProjectView(const MappedSnapshot& snapshot, const MappedProjectRecord& record)
+        : snapshot_(&snapshot), record_(&record) {}
+
+    const MappedSnapshot* snapshot_;
+    const MappedProjectRecord* record_;
+};
+
+class TalentView {
+public:
+    std::string_view id() const;
+    std::string_view name() const;
+    std::string_view email() const;
+    std::string_view timezone() const;
+    std::string_view preferredLanguage() const;
+    SkillSet skills() const { return SkillSet(record_->skills); }
+    ExperienceLevel experienceLevel() const { return static_cast<ExperienceLevel>(record_->experienceLevel); }
+    double hourlyRate() const { return record_->hourlyRate; }
+    bool isAvailable() const { return record_->isAvailable != 0; }
+    std::size_t completedProjectCount() const { return record_->completedProjects.count; }
+    std::string_view completedProject(std::size_t index) const;
+
+    Talent toTalent() const;
+
+private:
+    friend class MappedSnapshot;
+    TalentView(const MappedSnapshot& snapshot, const MappedTalentRecord& record)
+        : snapshot_(&snapshot), record_(&record) {}
+
+    const MappedSnapshot* snapshot_;
+    const MappedTalentRecord* record_;
+};
+
+// Read-only projects and talents served straight from a memory-mapped file.
+// Records are fixed-size, strings are offsets into a deduplicated string
+// section, and the ID hash tables and status/type/level orderings are built
+// by the writer, so opening only validates the header and maps the file.
+// Pages are shared through the page cache between every process that maps
+// the same snapshot, which lets standby readers start without loading it.
+//
+// Opening checks the layout but not the contents; call verify() to checksum
+// the whole file before trusting one from an unknown source.
+class MappedSnapshot {
+public:
+    // Throws std::runtime_error if the file is missing or malformed
+    explicit MappedSnapshot(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    // Sequence of the first log record not reflected in the snapshot
+    std::uint64_t walSequence() const;
+    bool verify() const;
+
+    // Projects
+    std::size_t projectCount() const { return projectCount_; }
+    std::optional<ProjectView> findProject(std::string_view projectId) const;
+    Project getProject(const std::string& projectId) const;
+    void forEachProject(const std::function<bool(const ProjectView&)>& visitor) const;
+    // In deadline order
+    void forEachProjectWithStatus(ProjectStatus status,
+                                  const std::function<bool(const ProjectView&)>& visitor) const;
+    void forEachProjectOfType(ProjectType type,
+                              const std::function<bool(const ProjectView&)>& visitor) const;
+    std::vector<Project> getProjectsByStatus(ProjectStatus status) const;
+
+    // Talents
+    std::size_t talentCount() const { return talentCount_; }
+    std::optional<TalentView> findTalent(std::string_view talentId) const;
+    Talent getTalent(const std::string& talentId) const;
+    // Walks the rate range inside the requested experience level(s), like
+    // TalentManager::forEachTalent
+    void forEachTalent(const TalentFilter& filter,
+                       const std::function<bool(const TalentView&)>& visitor) const;
+    std::vector<Talent> findTalents(const TalentFilter& filter) const;
+
+private:
+    friend class ProjectView;
+    friend class TalentView;
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+
+    const char* strings_ = nullptr;
+    const MappedStringRef* stringRefs_ = nullptr;
+    const MappedProjectRecord* projects_ = nullptr;
+    std::size_t projectCount_ = 0;
+    const std::uint32_t* projectTable_ = nullptr;   // ID hash table of record index + 1
+    std::size_t projectTableMask_ = 0;
+    const std::uint32_t* projectsByStatus_ = nullptr;
+    const std::uint32_t* projectStatusStarts_ = nullptr;
+    const std::uint32_t* projectsByType_ = nullptr;
+    const std::uint32_t* projectTypeStarts_ = nullptr;
+    const MappedTalentRecord* talents_ = nullptr;
+    std::size_t talentCount_ = 0;
+    const std::uint32_t* talentTable_ = nullptr;
+    std::size_t talentTableMask_ = 0;
+    const std::uint32_t* talentsByLevel_ = nullptr;  // By level, then hourly rate
+    const std::uint32_t* talentLevelStarts_ = nullptr;
+
+    std::string_view text(MappedStringRef ref) const { return std::string_view(strings_ + ref.offset, ref.length); }
+    std::string_view listItem(MappedListRef list, std::size_t index) const { return text(stringRefs_[list.first + index]); }
+    template <typename Record>
+    const Record* lookup(std::string_view id, const Record* records, const std::uint32_t* table,
+                         std::size_t mask) const;
+    void visitProjects(const std::uint32_t* order, const std::uint32_t* starts, std::size_t bucket,
+                       const std::function<bool(const ProjectView&)>& visitor) const;
+};
+
+// Writes the projects and talents as a mapped snapshot, replacing `path`
+// atomically. Like writeSnapshot it reads the managers shard by shard while
+// they keep serving.
+bool writeMappedSnapshot(const std::string& path, std::uint64_t walSequence,
+                         const ProjectManager& projects, const TalentManager& talents);
+
+} // namespace imagined
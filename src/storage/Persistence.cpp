@@ -0,0 +1,116 @@
+#include "Persistence.hpp"
+#include <filesystem>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "MappedSnapshot.hpp"
+#include "SnapshotFile.hpp"
+
+namespace imagined {
+
+StudioPersistence::StudioPersistence(std::string directory, ProjectManager& projectManager,
+                                     TalentManager& talentManager, ResourceAllocator& resourceAllocator)
+    : StudioPersistence(std::move(directory), projectManager, talentManager, resourceAllocator,
+                        WriteAheadLog::Options()) {}
+
+StudioPersistence::StudioPersistence(std::string directory, ProjectManager& projectManager,
+                                     TalentManager& talentManager, ResourceAllocator& resourceAllocator,
+                                     WriteAheadLog::Options options)
+    : directory_(std::move(directory)),
+      projectManager_(projectManager),
+      talentManager_(talentManager),
+      resourceAllocator_(resourceAllocator),
+      options_(options) {}
+
+StudioPersistence::~StudioPersistence() {
+    if (log_) {
+        attachLog(nullptr);
+    }
+}
+
+std::size_t StudioPersistence::recover() {
+    if (log_) {
+        throw std::runtime_error("Persistence already recovered");
+    }
+    std::filesystem::create_directories(directory_);
+
+    std::uint64_t walSequence = 1;
+    loadSnapshot(snapshotPath(), walSequence, projectManager_, talentManager_, resourceAllocator_);
+
+    std::size_t replayed = 0;
+    std::uint64_t last = WriteAheadLog::replay(directory_, walSequence, [&](const LogRecord& record) {
+        applyRecord(record);
+        ++replayed;
+    });
+
+    log_ = std::make_unique<WriteAheadLog>(directory_, last + 1, options_);
+    attachLog(log_.get());
+    return replayed;
+}
+
+bool StudioPersistence::checkpoint() {
+    if (!log_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    // Every record below this sequence is already applied to the managers
+    std::uint64_t walSequence = log_->nextSequence();
+    if (!writeSnapshot(snapshotPath(), walSequence, projectManager_, talentManager_, resourceAllocator_)) {
+        return false;
+    }
+    log_->removeSegmentsBefore(walSequence);
+    return true;
+}
+
+bool StudioPersistence::publishMappedSnapshot() {
+    if (!log_) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(checkpointMutex_);
+    return writeMappedSnapshot(mappedSnapshotPath(), log_->nextSequence(), projectManager_, talentManager_);
+}
+
+std::string StudioPersistence::mappedSnapshotPath() const {
+    return (std::filesystem::path(directory_) / "snapshot.map").string();
+}
+
+std::string StudioPersistence::snapshotPath() const {
+    return (std::filesystem::path(directory_) / "snapshot.bin").string();
+}
+
+void StudioPersistence::applyRecord(const LogRecord& record) {
+    BinaryReader in(record.payload.data(), record.payload.size());
+    switch (record.type) {
+        case LogRecordType::PUT_PROJECT:
+            projectManager_.restoreProject(decodeProject(in));
+            break;
+        case LogRecordType::ERASE_PROJECT:
+            projectManager_.deleteProject(in.str());
+            break;
+        case LogRecordType::PUT_TALENT:
+            talentManager_.restoreTalent(decodeTalent(in));
+            break;
+        case LogRecordType::ERASE_TALENT:
+            talentManager_.removeTalent(in.str());
+            break;
+        case LogRecordType::PUT_RESOURCE: {
+            std::vector<Booking> bookings;
+            Resource resource = decodeResource(in, bookings);
+            resourceAllocator_.restoreResource(resource, bookings);
+            break;
+        }
+        case LogRecordType::ERASE_RESOURCE:
+            resourceAllocator_.removeResource(in.str());
+            break;
+        default:
+            throw std::runtime_error("Unknown log record");
+    }
+}
+
+void StudioPersistence::attachLog(MutationLog* log) {
+    projectManager_.attachLog(log);
+    talentManager_.attachLog(log);
+    resourceAllocator_.attachLog(log);
+}
+
+} // namespace imagined
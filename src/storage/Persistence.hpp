@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "core/ProjectManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "core/TalentManager.hpp"
+#include "WriteAheadLog.hpp"
+
+namespace imagined {
+
+// Keeps the three managers durable in one directory: a snapshot file plus
+// the write-ahead log segments written since it was taken.
+//
+// recover() must be called once, on empty managers and before they are
+// shared between threads. It loads the snapshot, replays the log tail over
+// it and attaches a fresh log to all managers; from then on each mutation
+// returns only after its record is durable. checkpoint() may run
+// concurrently with mutations and lets the log drop the segments the new
+// snapshot covers. publishMappedSnapshot() writes the read-optimized
+// snapshot.map that standby readers open with MappedSnapshot.
+class StudioPersistence {
+public:
+    StudioPersistence(std::string directory, ProjectManager& projectManager,
+                      TalentManager& talentManager, ResourceAllocator& resourceAllocator);
+    StudioPersistence(std::string directory, ProjectManager& projectManager,
+                      TalentManager& talentManager, ResourceAllocator& resourceAllocator,
+                      WriteAheadLog::Options options);
+    ~StudioPersistence();
+
+    StudioPersistence(const StudioPersistence&) = delete;
+    StudioPersistence& operator=(const StudioPersistence&) = delete;
+
+    // Returns the number of log records replayed
+    std::size_t recover();
+    bool checkpoint();
+    bool publishMappedSnapshot();
+    std::string mappedSnapshotPath() const;
+
+private:
+    std::string directory_;
+    ProjectManager& projectManager_;
+    TalentManager& talentManager_;
+    ResourceAllocator& resourceAllocator_;
+    WriteAheadLog::Options options_;
+    std::unique_ptr<WriteAheadLog> log_;
+    std::mutex checkpointMutex_;
+
+    std::string snapshotPath() const;
+    void applyRecord(const LogRecord& record);
+    void attachLog(MutationLog* log);
+};
+
+} // namespace imagined
@@ -0,0 +1,150 @@
+#include "SnapshotFile.hpp"
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "BinaryCodec.hpp"
+#include "FileIO.hpp"
+
+namespace imagined {
+
+namespace {
+
+constexpr char kMagic[] = {'I', 'M', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::size_t kHeaderBytes = sizeof(kMagic) + 4 + 8;
+
+enum class SnapshotRecord : std::uint8_t {
+    END = 0,
+    PROJECT = 1,
+    TALENT = 2,
+    RESOURCE = 3
+};
+
+// Streams records to a file, keeping a running CRC of the bytes written
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(int fd) : fd_(fd) {}
+
+    bool write(const char* data, std::size_t size) {
+        checksum_ = crc32(data, size, checksum_);
+        return writeFully(fd_, data, size);
+    }
+
+    bool record(SnapshotRecord kind, const BinaryWriter& payload) {
+        BinaryWriter header;
+        header.u8(static_cast<std::uint8_t>(kind));
+        header.u32(static_cast<std::uint32_t>(payload.data().size()));
+        return write(header.data().data(), header.data().size()) &&
+               write(payload.data().data(), payload.data().size());
+    }
+
+    std::uint32_t checksum() const { return checksum_; }
+
+private:
+    int fd_;
+    std::uint32_t checksum_ = 0;
+};
+
+} // namespace
+
+bool writeSnapshot(const std::string& path, std::uint64_t walSequence,
+                   const ProjectManager& projects, const TalentManager& talents,
+                   const ResourceAllocator& resources) {
+    return replaceFile(path, [&](int fd) {
+        SnapshotWriter writer(fd);
+        BinaryWriter buffer;
+        buffer.data().append(kMagic, sizeof(kMagic));
+        buffer.u32(kVersion);
+        buffer.u64(walSequence);
+        bool ok = writer.write(buffer.data().data(), buffer.data().size());
+
+        projects.forEachProject([&](const Project& project) {
+            buffer.clear();
+            encodeProject(buffer, project);
+            ok = ok && writer.record(SnapshotRecord::PROJECT, buffer);
+            return ok;
+        });
+        talents.forEachTalent(TalentFilter{}, [&](const Talent& talent) {
+            buffer.clear();
+            encodeTalent(buffer, talent);
+            ok = ok && writer.record(SnapshotRecord::TALENT, buffer);
+            return ok;
+        });
+        std::vector<Booking> bookings;
+        resources.forEachResource([&](const Resource& resource, const BookingCalendar& calendar) {
+            bookings.clear();
+            calendar.forEachBooking([&](const Booking& booking) {
+                bookings.push_back(booking);
+                return true;
+            });
+            buffer.clear();
+            encodeResource(buffer, resource, bookings);
+            ok = ok && writer.record(SnapshotRecord::RESOURCE, buffer);
+            return ok;
+        });
+
+        buffer.clear();
+        ok = ok && writer.record(SnapshotRecord::END, buffer);
+        buffer.clear();
+        buffer.u32(writer.checksum());
+        return ok && writer.write(buffer.data().data(), buffer.data().size());
+    });
+}
+
+bool loadSnapshot(const std::string& path, std::uint64_t& walSequence,
+                  ProjectManager& projects, TalentManager& talents,
+                  ResourceAllocator& resources) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < kHeaderBytes + 4 || data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Invalid snapshot");
+    }
+
+    std::size_t bodyBytes = data.size() - 4;
+    BinaryReader trailer(data.data() + bodyBytes, 4);
+    if (trailer.u32() != crc32(data.data(), bodyBytes)) {
+        throw std::runtime_error("Snapshot checksum mismatch");
+    }
+
+    BinaryReader in(data.data(), bodyBytes);
+    in.bytes(sizeof(kMagic));
+    if (in.u32() != kVersion) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+    walSequence = in.u64();
+
+    std::vector<Booking> bookings;
+    while (true) {
+        auto kind = static_cast<SnapshotRecord>(in.u8());
+        std::uint32_t length = in.u32();
+        if (kind == SnapshotRecord::END) {
+            break;
+        }
+        BinaryReader payload(in.bytes(length), length);
+        switch (kind) {
+            case SnapshotRecord::PROJECT:
+                projects.restoreProject(decodeProject(payload));
+                break;
+            case SnapshotRecord::TALENT:
+                talents.restoreTalent(decodeTalent(payload));
+                break;
+            case SnapshotRecord::RESOURCE: {
+                Resource resource = decodeResource(payload, bookings);
+                resources.restoreResource(resource, bookings);
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown snapshot record");
+        }
+    }
+    if (!in.atEnd()) {
+        throw std::runtime_error("Trailing data after snapshot end");
+    }
+    return true;
+}
+
+} // namespace imagined
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "core/ProjectManager.hpp"
+#include "core/ResourceAllocator.hpp"
+#include "core/TalentManager.hpp"
+
+namespace imagined {
+
+// Point-in-time copy of all three managers, taken while they keep serving.
+// Each shard is read under its own read lock, so the snapshot is not one
+// consistent cut: it holds every change logged below `walSequence` and may
+// hold some later ones. Log records are full entity states, so replaying the
+// log from `walSequence` over it converges on the logged state.
+//
+// Layout: "IMSNAP" magic, u32 version, u64 walSequence, then records of
+// u8 kind, u32 length, payload, closed by kind 0 and a CRC-32 of everything
+// before it. The file is written beside the target and renamed into place.
+bool writeSnapshot(const std::string& path, std::uint64_t walSequence,
+                   const ProjectManager& projects, const TalentManager& talents,
+                   const ResourceAllocator& resources);
+
+// Loads a snapshot into empty managers and returns its walSequence through
+// `walSequence`. Returns false if there is no snapshot at `path`; throws
+// std::runtime_error if it is corrupt.
+bool loadSnapshot(const std::string& path, std::uint64_t& walSequence,
+                  ProjectManager& projects, TalentManager& talents,
+                  ResourceAllocator& resources);
+
+} // namespace imagined
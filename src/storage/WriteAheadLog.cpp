@@ -0,0 +1,260 @@
+#include "WriteAheadLog.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "FileIO.hpp"
+
+namespace imagined {
+
+namespace {
+
+constexpr std::size_t kFrameHeaderBytes = 4 + 4;  // Length and CRC
+constexpr std::size_t kFrameFixedBytes = 8 + 1;   // Sequence and type
+
+std::string segmentName(std::uint64_t firstSequence) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "wal-%020llu.log", static_cast<unsigned long long>(firstSequence));
+    return name;
+}
+
+// Segments of the directory as (first sequence, path), ascending
+std::vector<std::pair<std::uint64_t, std::filesystem::path>> listSegments(const std::string& directory) {
+    std::vector<std::pair<std::uint64_t, std::filesystem::path>> segments;
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = file.path().filename().string();
+        if (name.size() != 28 || name.compare(0, 4, "wal-") != 0 || name.compare(24, 4, ".log") != 0) {
+            continue;
+        }
+        segments.emplace_back(std::stoull(name.substr(4, 20)), file.path());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(std::string directory, std::uint64_t firstSequence)
+    : WriteAheadLog(std::move(directory), firstSequence, Options()) {}
+
+WriteAheadLog::WriteAheadLog(std::string directory, std::uint64_t firstSequence, Options options)
+    : directory_(std::move(directory)),
+      options_(options),
+      nextSequence_(std::max<std::uint64_t>(firstSequence, 1)),
+      durableSequence_(nextSequence_ - 1) {
+    std::filesystem::create_directories(directory_);
+    if (!openSegment(nextSequence_)) {
+        throw std::runtime_error("Cannot open write-ahead log segment");
+    }
+    flusher_ = std::thread([this] { flusherLoop(); });
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    appended_.notify_all();
+    flusher_.join();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+std::uint64_t WriteAheadLog::putProject(const Project& project) {
+    BinaryWriter payload;
+    encodeProject(payload, project);
+    return append(LogRecordType::PUT_PROJECT, payload);
+}
+
+std::uint64_t WriteAheadLog::eraseProject(const std::string& projectId) {
+    BinaryWriter payload;
+    payload.str(projectId);
+    return append(LogRecordType::ERASE_PROJECT, payload);
+}
+
+std::uint64_t WriteAheadLog::putTalent(const Talent& talent) {
+    BinaryWriter payload;
+    encodeTalent(payload, talent);
+    return append(LogRecordType::PUT_TALENT, payload);
+}
+
+std::uint64_t WriteAheadLog::eraseTalent(const std::string& talentId) {
+    BinaryWriter payload;
+    payload.str(talentId);
+    return append(LogRecordType::ERASE_TALENT, payload);
+}
+
+std::uint64_t WriteAheadLog::putResource(const Resource& resource, const std::vector<Booking>& bookings) {
+    BinaryWriter payload;
+    encodeResource(payload, resource, bookings);
+    return append(LogRecordType::PUT_RESOURCE, payload);
+}
+
+std::uint64_t WriteAheadLog::eraseResource(const std::string& resourceId) {
+    BinaryWriter payload;
+    payload.str(resourceId);
+    return append(LogRecordType::ERASE_RESOURCE, payload);
+}
+
+void WriteAheadLog::awaitDurable(std::uint64_t ticket) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    durable_.wait(lock, [&] { return durableSequence_ >= ticket || failed_; });
+    if (durableSequence_ < ticket) {
+        throw std::runtime_error("Write-ahead log write failed");
+    }
+}
+
+std::uint64_t WriteAheadLog::nextSequence() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nextSequence_;
+}
+
+void WriteAheadLog::flush() {
+    std::uint64_t last;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last = nextSequence_ - 1;
+    }
+    awaitDurable(last);
+}
+
+bool WriteAheadLog::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+void WriteAheadLog::removeSegmentsBefore(std::uint64_t sequence) {
+    auto segments = listSegments(directory_);
+    // A segment ends where the next one starts; the last one is still open
+    for (std::size_t i = 0; i + 1 < segments.size(); ++i) {
+        if (segments[i + 1].first <= sequence) {
+            std::error_code error;
+            std::filesystem::remove(segments[i].second, error);
+        }
+    }
+}
+
+std::uint64_t WriteAheadLog::replay(const std::string& directory, std::uint64_t fromSequence,
+                                    const std::function<void(const LogRecord&)>& visitor) {
+    std::uint64_t expected = fromSequence;
+    for (const auto& [firstSequence, path] : listSegments(directory)) {
+        if (firstSequence > expected) {
+            break;  // The records in between are lost
+        }
+        std::ifstream file(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::size_t offset = 0;
+        while (data.size() - offset >= kFrameHeaderBytes + kFrameFixedBytes) {
+            BinaryReader header(data.data() + offset, kFrameHeaderBytes);
+            std::uint32_t length = header.u32();
+            std::uint32_t checksum = header.u32();
+            std::size_t bodyBytes = kFrameFixedBytes + length;
+            const char* body = data.data() + offset + kFrameHeaderBytes;
+            if (data.size() - offset - kFrameHeaderBytes < bodyBytes || crc32(body, bodyBytes) != checksum) {
+                break;  // Torn or corrupt tail; the next segment may continue
+            }
+            offset += kFrameHeaderBytes + bodyBytes;
+
+            BinaryReader fixed(body, kFrameFixedBytes);
+            LogRecord record;
+            record.sequence = fixed.u64();
+            record.type = static_cast<LogRecordType>(fixed.u8());
+            if (record.sequence < expected) {
+                continue;
+            }
+            if (record.sequence > expected) {
+                return expected - 1;
+            }
+            record.payload.assign(body + kFrameFixedBytes, length);
+            visitor(record);
+            ++expected;
+        }
+    }
+    return expected - 1;
+}
+
+std::uint64_t WriteAheadLog::append(LogRecordType type, const BinaryWriter& payload) {
+    const std::string& bytes = payload.data();
+    BinaryWriter frame;
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t sequence = nextSequence_++;
+    if (failed_) {
+        // Not written; awaitDurable on the ticket throws
+        return sequence;
+    }
+
+    frame.u64(sequence);
+    frame.u8(static_cast<std::uint8_t>(type));
+    frame.data().append(bytes);
+    std::uint32_t checksum = crc32(frame.data().data(), frame.data().size());
+
+    BinaryWriter header;
+    header.u32(static_cast<std::uint32_t>(bytes.size()));
+    header.u32(checksum);
+    pending_.append(header.data());
+    pending_.append(frame.data());
+    appended_.notify_one();
+    return sequence;
+}
+
+void WriteAheadLog::flusherLoop() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        appended_.wait(lock, [&] { return stopping_ || !pending_.empty(); });
+        if (pending_.empty()) {
+            return;
+        }
+        if (options_.commitDelay.count() > 0 && !stopping_) {
+            lock.unlock();
+            std::this_thread::sleep_for(options_.commitDelay);
+            lock.lock();
+        }
+
+        batch.clear();
+        batch.swap(pending_);
+        std::uint64_t last = nextSequence_ - 1;
+        lock.unlock();
+
+        bool ok = writeFully(fd_, batch.data(), batch.size()) && (!options_.syncOnCommit || ::fdatasync(fd_) == 0);
+        segmentSize_ += batch.size();
+        if (ok && segmentSize_ >= options_.segmentBytes) {
+            ok = openSegment(last + 1);
+        }
+
+        lock.lock();
+        if (ok) {
+            durableSequence_ = last;
+        } else {
+            failed_ = true;
+            pending_.clear();
+        }
+        durable_.notify_all();
+    }
+}
+
+bool WriteAheadLog::openSegment(std::uint64_t firstSequence) {
+    std::string path = (std::filesystem::path(directory_) / segmentName(firstSequence)).string();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    syncDirectory(directory_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    segmentSize_ = 0;
+    return true;
+}
+
+} // namespace imagined
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "core/MutationLog.hpp"
+#include "BinaryCodec.hpp"
+
+namespace imagined {
+
+enum class LogRecordType : std::uint8_t {
+    PUT_PROJECT = 1,
+    ERASE_PROJECT,
+    PUT_TALENT,
+    ERASE_TALENT,
+    PUT_RESOURCE,
+    ERASE_RESOURCE
+};
+
+struct LogRecord {
+    std::uint64_t sequence;
+    LogRecordType type;
+    std::string payload;
+};
+
+// Append-only log of full-state entity records, split into segment files
+// named wal-<first sequence>.log inside one directory.
+//
+// Group commit: appends only copy the framed record into a shared buffer
+// under a mutex. A single flusher thread writes whatever has accumulated and
+// syncs it with one fdatasync, then wakes every caller whose record was in
+// the batch, so concurrent writers share the cost of each sync.
+//
+// Frame layout: u32 payload length, u32 CRC-32 of the rest, u64 sequence,
+// u8 type, payload. A torn or corrupt frame ends its segment; replay goes on
+// with the next segment only if it continues the sequence, which is the case
+// for a log reopened after a crash at the last intact record.
+//
+// A failed write or sync is final: later records are not written, and
+// awaitDurable throws for every ticket that did not become durable.
+class WriteAheadLog : public MutationLog {
+public:
+    struct Options {
+        bool syncOnCommit = true;                  // fdatasync every flushed batch
+        std::chrono::microseconds commitDelay{0};  // Extra wait to gather larger batches
+        std::size_t segmentBytes = 64u << 20;      // Start a new segment past this size
+    };
+
+    WriteAheadLog(std::string directory, std::uint64_t firstSequence);
+    WriteAheadLog(std::string directory, std::uint64_t firstSequence, Options options);
+    ~WriteAheadLog() override;
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    std::uint64_t putProject(const Project& project) override;
+    std::uint64_t eraseProject(const std::string& projectId) override;
+    std::uint64_t putTalent(const Talent& talent) override;
+    std::uint64_t eraseTalent(const std::string& talentId) override;
+    std::uint64_t putResource(const Resource& resource, const std::vector<Booking>& bookings) override;
+    std::uint64_t eraseResource(const std::string& resourceId) override;
+    void awaitDurable(std::uint64_t ticket) override;
+
+    // Sequence the next record will get; every earlier record is applied
+    std::uint64_t nextSequence() const;
+    // Waits until everything appended so far is durable; throws if the log
+    // has failed to write
+    void flush();
+    bool failed() const;
+    // Deletes segments that only hold records below `sequence`
+    void removeSegmentsBefore(std::uint64_t sequence);
+
+    // Visits the records with sequence >= fromSequence in order and returns
+    // the last sequence visited, or fromSequence - 1 if there is none
+    static std::uint64_t replay(const std::string& directory, std::uint64_t fromSequence,
+                                const std::function<void(const LogRecord&)>& visitor);
+
+private:
+    std::string directory_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable appended_;
+    std::condition_variable durable_;
+    std::string pending_;
+    std::uint64_t nextSequence_;
+    std::uint64_t durableSequence_;
+    bool stopping_ = false;
+    bool failed_ = false;
+
+    // Owned by the flusher thread
+    int fd_ = -1;
+    std::size_t segmentSize_ = 0;
+    std::thread flusher_;
+
+    std::uint64_t append(LogRecordType type, const BinaryWriter& payload);
+    void flusherLoop();
+    bool openSegment(std::uint64_t firstSequence);
+};
+
+} // namespace imagined